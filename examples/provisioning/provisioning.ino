@@ -0,0 +1,71 @@
+/*****************************************************************
+File:         provisioning.ino
+Description:  1.Four BM32S3021_1 on hardware Serial1~Serial4 (BAUDRATE 9600) of a BMduino 
+                are provisioned at the same time, Serial (BAUDRATE 9600) is used to 
+                communicate with the Serial port monitor.
+              2.Place the calibration target 20cm away from every module and send any 
+                key from the serial port monitor to start.
+              3.Every module is reset, configured with the profile below, read back, 
+                checked for its version and distance-learned. The 2s learning of all 
+                modules overlaps. PASS/FAIL of each module and the fixture throughput 
+                are printed.
+connection method： intPin:D22/D25/D3/D2  Serial1/Serial2/Serial3/Serial4
+******************************************************************/
+#include "BM32S3021-1.h"
+#include "BM32S3021-1_Provision.h"
+BM32S3021_1     unit1(22,&Serial1);
+BM32S3021_1     unit2(25,&Serial2);
+BM32S3021_1     unit3(3,&Serial3);
+BM32S3021_1     unit4(2,&Serial4);
+BM32S3021_1_Provision   fixture;
+
+uint8_t profile[6] = {7, 16, 50, 30, 0, 80};   //debounce, threshold, IRQ triger time, continuty, fastest, slowest
+
+void setup() 
+{
+  unit1.begin();
+  unit2.begin();
+  unit3.begin();
+  unit4.begin();
+  Serial.begin(9600);
+  fixture.addUnit(&unit1);
+  fixture.addUnit(&unit2);
+  fixture.addUnit(&unit3);
+  fixture.addUnit(&unit4);
+  fixture.setProfile(profile);   //Add the expected firmware version as 2nd parameter to check it
+}
+
+void loop() 
+{ 
+  uint8_t i = 0;
+  Serial.println("Place the target 20cm away and press a key");
+  while(Serial.available() == 0)
+  {
+  }
+  while(Serial.available() > 0)
+  {
+    Serial.read();
+  }
+  fixture.start();
+  while(!fixture.run())
+  {
+  }
+  for(i = 0; i < BM32S3021_1_PROVISION_UNITS; i++)
+  {
+    Serial.print("Unit ");
+    Serial.print(i + 1);
+    if(fixture.getResult(i) == BM32S3021_1_PROVISION_PASS)
+    {
+      Serial.println(": PASS");
+    }
+    else
+    {
+      Serial.print(": FAIL at step ");
+      Serial.println(fixture.getFailStep(i));
+    }
+  }
+  Serial.print("Fixture time(ms): ");
+  Serial.println(fixture.getElapsed());
+  Serial.print("Units per hour: ");
+  Serial.println(fixture.getUnitsPerHour());
+}
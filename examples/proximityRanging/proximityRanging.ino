@@ -0,0 +1,60 @@
+/*****************************************************************
+File:         proximityRanging.ino
+Description:  1.SoftwareSerial interface (BAUDRATE 9600)is used to communicate with BM32S3021_1.
+              2.hardware Serial (BAUDRATE 9600) is used to communicate with Serial port monitor.
+              3.Calibration: place the paper 20cm away from the module when "20cm" is 
+                printed, then 5cm and 10cm. Each step waits for a key from the serial 
+                port monitor.
+              4.The estimated hand distance is printed every 25ms and dims the LED on D9:
+                the closer the hand, the brighter the LED.
+connection method： intPin:D3 rxPin:D5 txPin:D4  LED:D9
+******************************************************************/
+#include "BM32S3021-1.h"
+#include "BM32S3021-1_Ranging.h"
+BM32S3021_1     myGesture(3,5,4); //intPin,rxPin,txPin,Please comment out this line of code if you don't use SW Serial
+//BM32S3021_1     myGesture(22,&Serial1); //Please uncomment out this line of code if you use HW Serial1 on BMduino
+BM32S3021_1_Ranging   myRanging(&myGesture);
+
+#define LED_PIN   9
+
+void waitKey(const char *prompt)
+{
+  Serial.println(prompt);
+  while(Serial.available() == 0)
+  {
+  }
+  while(Serial.available() > 0)
+  {
+    Serial.read();
+  }
+}
+
+void setup() 
+{
+  myGesture.begin(9600, 1);   //Probe the firmware for the shortest inter-command gap
+  Serial.begin(9600);
+  pinMode(LED_PIN, OUTPUT);
+  waitKey("20cm, then press a key");
+  myRanging.learnReference(200);      //Distance learning reference point, unit: mm
+  myRanging.addCalibrationPoint(200);
+  waitKey("5cm, then press a key");
+  myRanging.addCalibrationPoint(50);
+  waitKey("10cm, then press a key");
+  myRanging.addCalibrationPoint(100);
+  myRanging.begin(25, 2);             //Update every 25ms, low pass 1/4
+}
+
+void loop() 
+{ 
+  uint16_t distance = 0;
+  if(myRanging.update())
+  {
+    distance = myRanging.getDistance();
+    Serial.println(distance);
+    if(distance > 200)
+    {
+      distance = 200;
+    }
+    analogWrite(LED_PIN, 255 - distance * 255 / 200);
+  }
+}
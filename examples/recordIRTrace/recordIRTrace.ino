@@ -0,0 +1,64 @@
+/*****************************************************************
+File:         recordIRTrace.ino
+Description:  1.SoftwareSerial interface (BAUDRATE 9600)is used to communicate with BM32S3021_1.
+              2.hardware Serial (BAUDRATE 115200) is used to communicate with Serial port monitor.
+              3.Send 'L', 'R' or 'N' from the serial port monitor, then swipe left, swipe right
+                or do nothing in front of the module. The IR1/IR2 reference trace of the next 
+                1.5s is printed as "trace,t_ms,ir1,ir2,label" lines.
+              4.Save the printed lines to a .csv file and use it as the dataset of 
+                extras/gestureSweep to choose the gesture timing registers.
+              5.The module is probed at begin() so samples are not spaced by the 
+                10ms default command gap. One sample still takes about 15ms at 9600bps 
+                (14 bytes on the wire), and SoftwareSerial adds more; use a hardware 
+                UART for the finest traces. gestureSweep warns when the traces are 
+                much coarser than its 4ms model tick.
+connection method： intPin:D3 rxPin:D5 txPin:D4
+******************************************************************/
+#include "BM32S3021-1.h"
+BM32S3021_1     myGesture(3,5,4); //intPin,rxPin,txPin,Please comment out this line of code if you don't use SW Serial
+//BM32S3021_1     myGesture(22,&Serial1); //Please uncomment out this line of code if you use HW Serial1 on BMduino
+//BM32S3021_1     myGesture(25,&Serial2); //Please uncomment out this line of code if you use HW Serial2 on BMduino
+//BM32S3021_1     myGesture(3,&Serial3); //Please uncomment out this line of code if you use HW Serial3 on BMduino
+//BM32S3021_1     myGesture(3,&Serial4); //Please uncomment out this line of code if you use HW Serial4 on BMduino
+
+#define TRACE_TIME   1500   //Recording time of each trace, unit: ms
+
+uint8_t irRef[2] = {0};
+uint16_t traceNum = 0;
+
+void setup() 
+{
+  myGesture.begin(9600, 1);   //Probe the module for the shortest command gap
+  Serial.begin(115200);//Set the communication rate between the serial monitor and the Arduino to 115200 baud rate
+  Serial.println("trace,t_ms,ir1,ir2,label");
+}
+
+void loop() 
+{ 
+  char label = 0;
+  uint32_t startTime = 0;
+  if(Serial.available() > 0)
+  {
+    label = Serial.read();
+    if((label == 'L') || (label == 'R') || (label == 'N'))
+    {
+      startTime = millis();
+      while((millis() - startTime) < TRACE_TIME)
+      {
+        if(myGesture.readIRRef(irRef) == SUCCESS)   //Read IR1 & IR2 reference in one transaction
+        {
+          Serial.print(traceNum);
+          Serial.print(",");
+          Serial.print(millis() - startTime);
+          Serial.print(",");
+          Serial.print(irRef[0]);
+          Serial.print(",");
+          Serial.print(irRef[1]);
+          Serial.print(",");
+          Serial.println(label);
+        }
+      }
+      traceNum++;
+    }
+  }
+}
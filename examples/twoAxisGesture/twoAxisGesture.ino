@@ -0,0 +1,65 @@
+/*****************************************************************
+File:         twoAxisGesture.ino
+Description:  1.Two BM32S3021_1 are used: gestureX reads left/right, gestureY is 
+                mounted rotated by 90° and reads up/down. 
+              2.hardware Serial1/Serial2 (BAUDRATE 9600) are used to communicate with 
+                the modules, Serial (BAUDRATE 9600) with the Serial port monitor.
+              3.INT edges are timestamped (micros() at the read if no INT slot is 
+                free), and the swipes of both modules within
+                150ms are merged into one diagonal swipe. The serial port monitor 
+                prints "Swipe left/right/up/down" or diagonals such as "Swipe up right".
+connection method： gestureX intPin:D2 Serial1    gestureY intPin:D3 Serial2
+******************************************************************/
+#include "BM32S3021-1.h"
+#include "BM32S3021-1_Fusion.h"
+BM32S3021_1     gestureX(2,&Serial1);
+BM32S3021_1     gestureY(3,&Serial2);
+BM32S3021_1_Fusion  fusion(150000);   //Fusion window: 150ms
+
+uint8_t reported[2] = {0};
+uint8_t timestamped[2] = {0};
+
+void readAxis(BM32S3021_1 &gesture, uint8_t axis)
+{
+  uint8_t irStatus = 0;
+  if(gesture.getINT())
+  {
+    reported[axis] = 0;
+    return;
+  }
+  if(!reported[axis])
+  {
+    irStatus = gesture.getIRStatus();
+    if(!(irStatus&0x08) && (irStatus&0x06))    //calibration is completed and a swipe is decoded
+    {
+      fusion.update(axis, irStatus, timestamped[axis] ? gesture.getINTFallTime() : micros());
+      reported[axis] = 1;
+    }
+  }
+}
+
+void setup() 
+{
+  gestureX.begin();
+  gestureY.begin();
+  timestamped[BM32S3021_1_AXIS_X] = (gestureX.enableINTTimestamp() == SUCCESS);
+  timestamped[BM32S3021_1_AXIS_Y] = (gestureY.enableINTTimestamp() == SUCCESS);
+  Serial.begin(9600);
+}
+
+void loop() 
+{ 
+  uint8_t swipe = 0;
+  readAxis(gestureX, BM32S3021_1_AXIS_X);
+  readAxis(gestureY, BM32S3021_1_AXIS_Y);
+  swipe = fusion.poll(micros());
+  if(swipe != BM32S3021_1_SWIPE_NONE)
+  {
+    Serial.print("Swipe");
+    if(swipe & BM32S3021_1_SWIPE_UP)    Serial.print(" up");
+    if(swipe & BM32S3021_1_SWIPE_DOWN)  Serial.print(" down");
+    if(swipe & BM32S3021_1_SWIPE_LEFT)  Serial.print(" left");
+    if(swipe & BM32S3021_1_SWIPE_RIGHT) Serial.print(" right");
+    Serial.println("");
+  }
+}
@@ -0,0 +1,25 @@
+/*****************************************************************
+File:         basic.ino
+Description:  Fixed sketch for extras/footprint/footprint.sh. It only 
+              reads the gesture with getIRStatus() and is built unchanged 
+              in every feature switch configuration, so a switch that 
+              saves nothing for such a sketch shows the same size.
+connection method： intPin:D3 RX/TX:Serial
+******************************************************************/
+#include "BM32S3021-1.h"
+BM32S3021_1     myGesture(3,&Serial);
+
+uint8_t irStatus = 0;
+
+void setup() 
+{
+  myGesture.begin(); 
+}
+
+void loop() 
+{ 
+  if(!myGesture.getINT())
+  {
+    irStatus = myGesture.getIRStatus();
+  }
+}
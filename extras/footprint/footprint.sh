@@ -0,0 +1,57 @@
+#!/bin/sh
+#*****************************************************************
+# File:         footprint.sh
+# Description:  Build the fixed getIRStatus() sketch extras/footprint/basic 
+#               with arduino-cli in each feature switch configuration, and 
+#               the full-API sketch extras/footprint/full with every switch 
+#               on, and report flash and RAM usage.
+# Usage:        footprint.sh [fqbn] [baseline] > footprint.txt
+#               fqbn:     board to build for (default arduino:avr:uno)
+#               baseline: file written by a previous run; the script 
+#                         fails if any configuration grew
+#*****************************************************************
+FQBN=${1:-arduino:avr:uno}
+BASELINE=$2
+DIR=$(cd "$(dirname "$0")" && pwd)
+LIB=$(cd "$DIR/../.." && pwd)
+
+# flags <tuning> <calibration> <diagnostics> <softserial>
+flags()
+{
+    echo "-DBM32S3021_1_TUNING=$1 -DBM32S3021_1_CALIBRATION=$2 -DBM32S3021_1_DIAGNOSTICS=$3 -DBM32S3021_1_SOFTSERIAL=$4"
+}
+STATUS=0
+
+# measure <name> <sketch> <flags>
+measure()
+{
+    out=$(arduino-cli compile --fqbn "$FQBN" --library "$LIB" \
+          --build-property "compiler.cpp.extra_flags=$3" "$DIR/$2" 2>&1)
+    if [ $? -ne 0 ]; then
+        echo "$out" >&2
+        echo "$1 build failed" >&2
+        exit 1
+    fi
+    flash=$(echo "$out" | sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p')
+    ram=$(echo "$out" | sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p')
+    printf "%-12s %8s %8s\n" "$1" "$flash" "$ram"
+    if [ -n "$BASELINE" ] && [ -f "$BASELINE" ]; then
+        base=$(awk -v n="$1" '$1 == n { print $2, $3 }' "$BASELINE")
+        if [ -n "$base" ]; then
+            set -- $base
+            if [ "$flash" -gt "$1" ] || [ "$ram" -gt "$2" ]; then
+                echo "  regression: baseline flash $1 ram $2" >&2
+                STATUS=1
+            fi
+        fi
+    fi
+}
+
+printf "%-12s %8s %8s\n" "config" "flash" "ram"
+measure full       basic "$(flags 1 1 1 1)"
+measure minimal    basic "$(flags 0 0 0 0)"
+measure softserial basic "$(flags 0 0 0 1)"
+measure tuning     basic "$(flags 1 0 0 0)"
+measure diagnostic basic "$(flags 0 0 1 0)"
+measure full-api   full  "$(flags 1 1 1 1)"
+exit $STATUS
@@ -0,0 +1,36 @@
+/*****************************************************************
+File:         full.ino
+Description:  Full-API sketch for extras/footprint/footprint.sh, built 
+              with every feature switch at 1. It calls every public API,
+              so it reports the cost of the whole library.
+connection method： intPin:D3 rxPin:D5 txPin:D4
+******************************************************************/
+#include "BM32S3021-1.h"
+BM32S3021_1     myGesture(3,5,4);
+
+uint8_t buff[6] = {0};
+
+void setup() 
+{
+  myGesture.begin(); 
+  buff[0] = myGesture.getFWVer();
+  buff[1] = myGesture.getIRGestureNum();
+  myGesture.readIRRef(buff);
+  myGesture.probeCapability();
+  myGesture.getIRParameters(buff);
+  myGesture.setIRParameters(buff);
+  myGesture.setIRDebounce();
+  myGesture.setIRThreshold();
+  myGesture.setIRQTrigerTime();
+  myGesture.setIRContinutyGestureTime();
+  myGesture.setIRFastestGestureTime();
+  myGesture.setIRSlowestGestureTime();
+}
+
+void loop() 
+{ 
+  if(!myGesture.getINT())
+  {
+    buff[0] = myGesture.getIRStatus();
+  }
+}
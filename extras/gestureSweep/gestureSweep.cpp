@@ -0,0 +1,373 @@
+/*****************************************************************
+File:             gestureSweep.cpp
+Author:           BEST MODULES CORP.
+Description:      Host tool: sweep the BM32S3021_1 gesture timing registers
+                  against recorded IR reference traces and report recognition
+                  rate vs detection latency of each configuration
+Build:            g++ -std=c++11 -O2 -o gestureSweep gestureSweep.cpp
+Usage:            gestureSweep dataset.csv [--max-latency ms] [--swap]
+                                           [--continuity n] [--all]
+******************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define TICK_MS         4     //Module gesture engine tick
+#define MAX_INTERVAL_MS (2 * TICK_MS)   //Coarser traces do not resolve single ticks
+
+struct Sample
+{
+    int tMs;
+    int ir[2];
+};
+
+struct Trace
+{
+    int id;
+    std::string label;        //Expected gestures: "L", "R", "LR"..., "N" for none
+    std::vector<Sample> samples;
+    std::vector<int> sig[2];  //Resampled |ref - baseline| per TICK_MS
+    std::vector<int> onset;   //Ticks where the hand starts to cover the module
+};
+
+struct Config
+{
+    int debounce;
+    int threshold;
+    int irqTime;
+    int fastest;
+    int slowest;
+    double rate;
+    double latencyMs;
+};
+
+struct Detection
+{
+    char dir;
+    int latencyMs;
+};
+
+/**********************************************************
+Description: Load "trace,t_ms,ir1,ir2,label" lines
+Parameters:  path: dataset file printed by examples/recordIRTrace
+             traces: Stores the loaded traces
+Return:      0:Success 1:Fail
+Others:
+**********************************************************/
+static int loadDataset(const char *path, std::vector<Trace> &traces)
+{
+    std::ifstream in(path);
+    std::string line;
+    if(!in)
+    {
+      return 1;
+    }
+    while(std::getline(in, line))
+    {
+      Sample s;
+      int id = 0;
+      char label[16] = {0};
+      if(sscanf(line.c_str(), "%d,%d,%d,%d,%15s", &id, &s.tMs, &s.ir[0], &s.ir[1], label) != 5)
+      {
+        continue;       //Header or comment line
+      }
+      if(traces.empty() || traces.back().id != id)
+      {
+        traces.push_back(Trace());
+        traces.back().id = id;
+        traces.back().label = (label[0] == 'N') ? "" : label;
+      }
+      traces.back().samples.push_back(s);
+    }
+    return traces.empty() ? 1 : 0;
+}
+
+/**********************************************************
+Description: Resample a trace to the module tick
+Parameters:  t: trace to be resampled
+Return:
+Others:      The baseline of each channel is the first sample,
+             the signal is the distance from the baseline. A gesture 
+             onset is where the larger channel rises through half of 
+             the trace peak; it does not depend on the configuration, 
+             so it is the reference of the detection latency
+**********************************************************/
+static void resample(Trace &t)
+{
+    size_t j = 0;
+    int end = t.samples.back().tMs;
+    for(int tMs = t.samples.front().tMs; tMs <= end; tMs += TICK_MS)
+    {
+      while(j + 1 < t.samples.size() && t.samples[j + 1].tMs <= tMs)
+      {
+        j++;
+      }
+      for(int ch = 0; ch < 2; ch++)
+      {
+        int v = t.samples[j].ir[ch];
+        if(j + 1 < t.samples.size() && t.samples[j + 1].tMs > t.samples[j].tMs)
+        {
+          const Sample &a = t.samples[j];
+          const Sample &b = t.samples[j + 1];
+          v = a.ir[ch] + (b.ir[ch] - a.ir[ch]) * (tMs - a.tMs) / (b.tMs - a.tMs);
+        }
+        t.sig[ch].push_back(std::abs(v - t.samples.front().ir[ch]));
+      }
+    }
+    int peak = 0;
+    for(size_t i = 0; i < t.sig[0].size(); i++)
+    {
+      peak = std::max(peak, std::max(t.sig[0][i], t.sig[1][i]));
+    }
+    for(size_t i = 0; peak > 0 && i < t.sig[0].size(); i++)
+    {
+      int level = std::max(t.sig[0][i], t.sig[1][i]);
+      int last = (i == 0) ? 0 : std::max(t.sig[0][i - 1], t.sig[1][i - 1]);
+      if(level * 2 >= peak && last * 2 < peak)
+      {
+        t.onset.push_back((int)i);
+      }
+    }
+}
+
+/**********************************************************
+Description: Mean sample interval of the dataset
+Parameters:  traces: loaded traces
+Return:      interval, unit: ms
+Others:
+**********************************************************/
+static double sampleInterval(const std::vector<Trace> &traces)
+{
+    long span = 0, steps = 0;
+    for(size_t i = 0; i < traces.size(); i++)
+    {
+      span += traces[i].samples.back().tMs - traces[i].samples.front().tMs;
+      steps += (long)traces[i].samples.size() - 1;
+    }
+    return steps ? (double)span / steps : 0;
+}
+
+/**********************************************************
+Description: Model of the module gesture engine
+Parameters:  t: resampled trace
+             c: register configuration
+             swap: IR2 triggers before IR1 on a right swipe
+             out: Stores the detected gestures
+Return:
+Others:      A channel turns on/off after debounce+1 ticks on the
+             other side of the threshold. A gesture is both channels
+             turning on and off; the first channel gives the direction,
+             the on->off span is checked against the fastest/slowest
+             gesture time. INT is asserted when a gesture is decoded 
+             and held for irqTime×4ms; a gesture decoded while INT is 
+             held is reported when the hold ends. The latency is the 
+             time from the gesture onset (see resample()) to its INT 
+             assertion, so it includes the debounce, the release of 
+             the hand and the IRQ trigger time of a previous report.
+**********************************************************/
+static void simulate(const Trace &t, const Config &c, bool swap, std::vector<Detection> &out)
+{
+    int n = (int)t.sig[0].size();
+    int state[2] = {0, 0}, run[2] = {0, 0};
+    int onTick[2] = {-1, -1}, offTick[2] = {-1, -1}, rawOff[2] = {-1, -1};
+    int intUntil = -1;
+    int fastestMs = 20 + c.fastest * TICK_MS;
+    int slowestMs = c.slowest * 16;
+    for(int i = 0; i < n; i++)
+    {
+      for(int ch = 0; ch < 2; ch++)
+      {
+        int above = t.sig[ch][i] >= c.threshold;
+        if(above != state[ch])
+        {
+          if(run[ch]++ == 0 && !above)
+          {
+            rawOff[ch] = i;
+          }
+          if(run[ch] > c.debounce)
+          {
+            state[ch] = above;
+            run[ch] = 0;
+            if(above && onTick[ch] < 0)
+            {
+              onTick[ch] = i - c.debounce;
+            }
+            else if(!above && onTick[ch] >= 0)
+            {
+              offTick[ch] = i;
+            }
+          }
+        }
+        else
+        {
+          run[ch] = 0;
+        }
+      }
+      if(offTick[0] >= 0 && offTick[1] >= 0 && !state[0] && !state[1])
+      {
+        int spanMs = (std::max(rawOff[0], rawOff[1]) - std::min(onTick[0], onTick[1])) * TICK_MS;
+        if(onTick[0] != onTick[1] && spanMs >= fastestMs && spanMs <= slowestMs)
+        {
+          Detection d;
+          int intTick = std::max(i, intUntil);
+          int onset = std::min(onTick[0], onTick[1]);
+          for(size_t j = 0; j < t.onset.size() && t.onset[j] <= i; j++)
+          {
+            onset = t.onset[j];
+          }
+          d.dir = ((onTick[0] < onTick[1]) != swap) ? 'R' : 'L';
+          d.latencyMs = (intTick - onset) * TICK_MS;
+          out.push_back(d);
+          intUntil = intTick + c.irqTime;
+        }
+        onTick[0] = onTick[1] = offTick[0] = offTick[1] = -1;
+      }
+      else if((offTick[0] >= 0 && onTick[1] < 0 && (i - onTick[0]) * TICK_MS > slowestMs) ||
+              (offTick[1] >= 0 && onTick[0] < 0 && (i - onTick[1]) * TICK_MS > slowestMs))
+      {
+        onTick[0] = onTick[1] = offTick[0] = offTick[1] = -1;   //Only one channel triggered
+      }
+    }
+}
+
+/**********************************************************
+Description: Score one configuration over the dataset
+Parameters:  traces: resampled traces
+             c: configuration, rate and latencyMs are filled in
+             swap: see simulate()
+Return:
+Others:      A trace is recognised when the detected directions
+             match its label exactly
+**********************************************************/
+static void score(const std::vector<Trace> &traces, Config &c, bool swap)
+{
+    int ok = 0, latencySum = 0, latencyCnt = 0;
+    for(size_t i = 0; i < traces.size(); i++)
+    {
+      std::vector<Detection> det;
+      std::string got;
+      simulate(traces[i], c, swap, det);
+      for(size_t j = 0; j < det.size(); j++)
+      {
+        got += det[j].dir;
+      }
+      if(got == traces[i].label)
+      {
+        ok++;
+        for(size_t j = 0; j < det.size(); j++)
+        {
+          latencySum += det[j].latencyMs;
+          latencyCnt++;
+        }
+      }
+    }
+    c.rate = 100.0 * ok / traces.size();
+    c.latencyMs = latencyCnt ? (double)latencySum / latencyCnt : 0;
+}
+
+static bool better(const Config &a, const Config &b)
+{
+    if(a.rate != b.rate)
+    {
+      return a.rate > b.rate;
+    }
+    return a.latencyMs < b.latencyMs;
+}
+
+int main(int argc, char *argv[])
+{
+    static const int debounces[] = {0, 1, 2, 3, 5, 7, 10, 15};
+    static const int thresholds[] = {10, 12, 16, 20, 24, 32, 48, 64};
+    static const int irqTimes[] = {25, 50, 75, 100};
+    static const int fastests[] = {0, 2, 5, 10, 20};
+    static const int slowests[] = {40, 60, 80, 120, 160, 200};
+    std::vector<Trace> traces;
+    std::vector<Config> results;
+    double maxLatency = 1e9;
+    bool swap = false, all = false;
+    int continuity = 30;
+    const char *path = NULL;
+
+    for(int i = 1; i < argc; i++)
+    {
+      if(!strcmp(argv[i], "--max-latency") && i + 1 < argc)
+      {
+        maxLatency = atof(argv[++i]);
+      }
+      else if(!strcmp(argv[i], "--continuity") && i + 1 < argc)
+      {
+        continuity = atoi(argv[++i]);
+      }
+      else if(!strcmp(argv[i], "--swap"))
+      {
+        swap = true;
+      }
+      else if(!strcmp(argv[i], "--all"))
+      {
+        all = true;
+      }
+      else
+      {
+        path = argv[i];
+      }
+    }
+    if(path == NULL || loadDataset(path, traces))
+    {
+      fprintf(stderr, "usage: %s dataset.csv [--max-latency ms] [--swap] [--continuity n] [--all]\n", argv[0]);
+      return 1;
+    }
+    for(size_t i = 0; i < traces.size(); i++)
+    {
+      resample(traces[i]);
+    }
+    if(sampleInterval(traces) > MAX_INTERVAL_MS)
+    {
+      fprintf(stderr, "warning: traces are sampled every %.1f ms, the model runs every %d ms. "
+              "Debounce and fastest time steps shorter than one sample are interpolated, not measured. "
+              "Record with a probed module (begin(9600, 1)) on a hardware UART.\n",
+              sampleInterval(traces), TICK_MS);
+    }
+
+    for(size_t a = 0; a < sizeof(debounces) / sizeof(int); a++)
+    for(size_t b = 0; b < sizeof(thresholds) / sizeof(int); b++)
+    for(size_t d = 0; d < sizeof(irqTimes) / sizeof(int); d++)
+    for(size_t e = 0; e < sizeof(fastests) / sizeof(int); e++)
+    for(size_t f = 0; f < sizeof(slowests) / sizeof(int); f++)
+    {
+      Config c = {debounces[a], thresholds[b], irqTimes[d], fastests[e], slowests[f], 0, 0};
+      score(traces, c, swap);
+      results.push_back(c);
+    }
+    std::stable_sort(results.begin(), results.end(), better);
+
+    printf("debounce,threshold,irq_time,fastest,slowest,recognition_pct,latency_ms\n");
+    for(size_t i = 0; i < results.size() && (all || i < 20); i++)
+    {
+      const Config &c = results[i];
+      printf("%d,%d,%d,%d,%d,%.1f,%.1f\n", c.debounce, c.threshold, c.irqTime,
+             c.fastest, c.slowest, c.rate, c.latencyMs);
+    }
+
+    for(size_t i = 0; i < results.size(); i++)
+    {
+      const Config &c = results[i];
+      if(c.latencyMs <= maxLatency)
+      {
+        printf("\n// Profile: %u traces, recognition %.1f%%, mean detection latency %.1f ms\n",
+               (unsigned)traces.size(), c.rate, c.latencyMs);
+        printf("myGesture.setIRDebounce(%d);\n", c.debounce);
+        printf("myGesture.setIRThreshold(%d);\n", c.threshold);
+        printf("myGesture.setIRQTrigerTime(%d);\n", c.irqTime);
+        printf("myGesture.setIRContinutyGestureTime(%d);\n", continuity);
+        printf("myGesture.setIRFastestGestureTime(%d);\n", c.fastest);
+        printf("myGesture.setIRSlowestGestureTime(%d);\n", c.slowest);
+        return 0;
+      }
+    }
+    fprintf(stderr, "no configuration within %.1f ms latency\n", maxLatency);
+    return 2;
+}
@@ -0,0 +1,68 @@
+/*****************************************************************
+File:             Arduino.h
+Author:           BEST MODULES CORP.
+Description:      Host stand-in for the parts of the Arduino core used by
+                  BM32S3021_1 and BM32S3021_1_Task, for taskStress.cpp only
+******************************************************************/
+#ifndef _BM32S3021_1_HOST_ARDUINO_H_
+#define _BM32S3021_1_HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+#define LOW             0
+#define HIGH            1
+#define CHANGE          1
+#define NOT_AN_INTERRUPT  -1
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+int digitalRead(uint8_t pin);
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+inline void attachInterrupt(uint8_t, void (*)(void), int) {}
+inline void detachInterrupt(uint8_t) {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t data) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+      size_t i = 0;
+      for(i = 0; i < size; i++)
+      {
+        write(buffer[i]);
+      }
+      return size;
+    }
+};
+
+class Stream : public Print
+{
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() {}
+};
+
+class HardwareSerial : public Stream
+{
+  public:
+    virtual void begin(unsigned long baud) = 0;
+    using Print::write;
+};
+
+extern HardwareSerial &Serial;
+
+#endif
@@ -0,0 +1,355 @@
+/*****************************************************************
+File:             taskStress.cpp
+Author:           BEST MODULES CORP.
+Description:      Host tool: several client threads call one
+                  BM32S3021_1_Task against an emulated module and check
+                  that every reply reaches the thread that asked for it
+Build:            g++ -std=c++11 -O2 -pthread -DBM32S3021_1_SOFTSERIAL=0
+                      -I. -I../../src -o taskStress taskStress.cpp
+                      ../../src/BM32S3021-1.cpp ../../src/BM32S3021-1_OS.cpp
+                      ../../src/BM32S3021-1_Task.cpp
+Usage:            taskStress [--iterations n] [--gestures n]
+******************************************************************/
+#include "BM32S3021-1_Task.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define INT_PIN         3
+#define CLIENTS         6     //One per gesture parameter register
+#define FW_VERSION      0x0104
+#define SWIPE_STATUS    0x02
+#define REPLY_US        300   //Module turnaround of the emulated module
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+static std::atomic<int> intLevel(HIGH);
+
+unsigned long micros()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long millis()
+{
+    return micros() / 1000;
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+int digitalRead(uint8_t pin)
+{
+    return (pin == INT_PIN) ? intLevel.load() : HIGH;
+}
+
+/**********************************************************
+Description: Emulated module on the UART
+Others:      Answers read frames from its register map and
+             acknowledges write, reset and learning frames.
+             The replies become readable REPLY_US after the
+             command. Every byte of a frame and of its reply must
+             be handled by the same thread, otherwise two callers
+             shared the UART.
+**********************************************************/
+class MockModule : public HardwareSerial
+{
+  public:
+    MockModule()
+    {
+      memset(reg, 0, sizeof(reg));
+      reg[0] = FW_VERSION & 0xFF;
+      reg[1] = FW_VERSION >> 8;
+    }
+    void begin(unsigned long) {}
+    int available()
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      if(!reply.empty())
+      {
+        check();
+      }
+      return (micros() - replyAt < 0x80000000UL) ? (int)reply.size() : 0;
+    }
+    int read()
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      int data = -1;
+      if(!reply.empty() && (micros() - replyAt < 0x80000000UL))
+      {
+        check();
+        data = reply.front();
+        reply.pop_front();
+      }
+      return data;
+    }
+    int peek()
+    {
+      return -1;
+    }
+    size_t write(uint8_t data)
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      if(frame.empty())
+      {
+        owner = std::this_thread::get_id();
+      }
+      else
+      {
+        check();
+      }
+      frame.push_back(data);
+      decode();
+      return 1;
+    }
+    void setStatus(uint8_t status)
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      reg[2] = status;
+    }
+    uint8_t getReg(uint8_t addr)
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      return reg[addr];
+    }
+    unsigned long frames = 0;
+    unsigned long badFrames = 0;
+    unsigned long crossed = 0;
+
+  private:
+    void check()
+    {
+      if(owner != std::this_thread::get_id())
+      {
+        crossed++;
+      }
+    }
+    void decode()
+    {
+      size_t need = 3;
+      uint8_t sum = 0;
+      size_t i = 0;
+      std::vector<uint8_t> r;
+      if(frame.size() < 2)
+      {
+        return;
+      }
+      if(frame[1] == 0x80)
+      {
+        need = 5;
+      }
+      else if(frame[1] == 0xC0)
+      {
+        need = (frame.size() >= 4) ? (size_t)5 + frame[3] : 5;
+      }
+      if(frame.size() < need)
+      {
+        return;
+      }
+      for(i = 0; i + 1 < frame.size(); i++)
+      {
+        sum += frame[i];
+      }
+      frames++;
+      if((frame[0] != 0x55) || (sum != frame.back()))
+      {
+        badFrames++;
+        frame.clear();
+        return;
+      }
+      if(frame[1] == 0x80)
+      {
+        r.push_back(0x55);
+        r.push_back(0x80);
+        r.push_back(frame[2]);
+        r.push_back(frame[3]);
+        for(i = 0; i < frame[3]; i++)
+        {
+          r.push_back(reg[(frame[2] + i) % sizeof(reg)]);
+        }
+      }
+      else
+      {
+        if(frame[1] == 0xC0)
+        {
+          for(i = 0; i < frame[3]; i++)
+          {
+            reg[(frame[2] + i) % sizeof(reg)] = frame[4 + i];
+          }
+        }
+        r.push_back(0x55);
+        r.push_back(0x7F);
+      }
+      sum = 0;
+      for(i = 0; i < r.size(); i++)
+      {
+        sum += r[i];
+      }
+      r.push_back(sum);
+      reply.assign(r.begin(), r.end());
+      replyAt = micros() + REPLY_US;
+      frame.clear();
+    }
+    std::mutex lock;
+    uint8_t reg[0x30];
+    std::vector<uint8_t> frame;
+    std::deque<uint8_t> reply;
+    unsigned long replyAt = 0;
+    std::thread::id owner;
+};
+
+static MockModule *module = new MockModule();
+HardwareSerial &Serial = *module;
+
+typedef uint8_t (BM32S3021_1_Task::*Setter)(uint8_t);
+static const Setter setters[CLIENTS] =
+{
+    &BM32S3021_1_Task::setIRDebounce,
+    &BM32S3021_1_Task::setIRThreshold,
+    &BM32S3021_1_Task::setIRQTrigerTime,
+    &BM32S3021_1_Task::setIRContinutyGestureTime,
+    &BM32S3021_1_Task::setIRFastestGestureTime,
+    &BM32S3021_1_Task::setIRSlowestGestureTime,
+};
+
+static std::atomic<unsigned long> calls(0);
+static std::atomic<unsigned long> wrong(0);
+
+/**********************************************************
+Description: Client thread
+Parameters:  task: shared driver task
+             k: gesture parameter owned by this client
+             iterations: number of set/get rounds
+Return:
+Others:      Only client k writes parameter k, so the block read
+             that follows must return the value it just wrote
+**********************************************************/
+static void client(BM32S3021_1_Task *task, int k, int iterations)
+{
+    uint8_t buff[6] = {0};
+    uint8_t value = 0;
+    for(int i = 0; i < iterations; i++)
+    {
+      value = (uint8_t)(k * 37 + i);
+      if((task->*setters[k])(value) != SUCCESS)
+      {
+        wrong++;
+      }
+      memset(buff, 0xFF - value, sizeof(buff));
+      if((task->getIRParameters(buff) != SUCCESS) || (buff[k] != value))
+      {
+        wrong++;
+      }
+      if(task->getFWVer() != FW_VERSION)
+      {
+        wrong++;
+      }
+      calls += 3;
+    }
+}
+
+/**********************************************************
+Description: Gesture event reader
+Parameters:  task: shared driver task
+             expected: number of swipes generated
+             got: Stores the number of swipe events read
+Return:
+Others:      Gives up after one second without an event
+**********************************************************/
+static void reader(BM32S3021_1_Task *task, int expected, int *got)
+{
+    BM32S3021_1_Event event;
+    while(*got < expected)
+    {
+      if(task->getGestureEvent(&event, 1000) != SUCCESS)
+      {
+        return;
+      }
+      if(event.irStatus != SWIPE_STATUS)
+      {
+        wrong++;
+      }
+      (*got)++;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = 200, gestures = 20, got = 0;
+    std::vector<std::thread> threads;
+    for(int i = 1; i < argc; i++)
+    {
+      if(!strcmp(argv[i], "--iterations") && i + 1 < argc)
+      {
+        iterations = atoi(argv[++i]);
+      }
+      else if(!strcmp(argv[i], "--gestures") && i + 1 < argc)
+      {
+        gestures = atoi(argv[++i]);
+      }
+      else
+      {
+        fprintf(stderr, "usage: %s [--iterations n] [--gestures n]\n", argv[0]);
+        return 1;
+      }
+    }
+
+    BM32S3021_1 *gesture = new BM32S3021_1(INT_PIN, &Serial);
+    BM32S3021_1_Task *task = new BM32S3021_1_Task(gesture);
+    if(task->begin(9600, 1) != SUCCESS)
+    {
+      fprintf(stderr, "begin failed\n");
+      return 1;
+    }
+    for(int k = 0; k < CLIENTS; k++)
+    {
+      threads.push_back(std::thread(client, task, k, iterations));
+    }
+    threads.push_back(std::thread(reader, task, gestures, &got));
+    for(int i = 0; i < gestures; i++)
+    {
+      module->setStatus(SWIPE_STATUS);
+      intLevel = LOW;
+      delay(40);
+      intLevel = HIGH;
+      module->setStatus(0);
+      delay(40);
+    }
+    for(size_t i = 0; i < threads.size(); i++)
+    {
+      threads[i].join();
+    }
+
+    printf("capability %02x, gap %u us\n", gesture->getCapability(), gesture->getTurnaround());
+    printf("%lu calls, %lu wrong replies\n", calls.load(), wrong.load());
+    printf("%lu frames, %lu bad checksums, %lu shared frames\n", module->frames, module->badFrames, module->crossed);
+    printf("%d of %d gesture events\n", got, gestures);
+    for(int k = 0; k < CLIENTS; k++)
+    {
+      if(module->getReg(6 + k) != (uint8_t)(k * 37 + iterations - 1))
+      {
+        printf("parameter %d is %u\n", k, module->getReg(6 + k));
+        wrong++;
+      }
+    }
+    if(wrong || module->badFrames || module->crossed || (got != gestures))
+    {
+      printf("FAIL\n");
+      return 2;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -5,6 +5,9 @@ Description:      UART communication with the BM32S3021_1 and obtain the corresp
 Version:          V1.0.4   -- 2025-03-13
 ******************************************************************/
 #include "BM32S3021-1.h"
+
+BM32S3021_1 *BM32S3021_1::_intInstance[BM32S3021_1_MAX_INT_INSTANCES] = {NULL};
+void (* const BM32S3021_1::_intISR[BM32S3021_1_MAX_INT_INSTANCES])() = {intISR0, intISR1};
 /**********************************************************
 Description: Constructor
 Parameters:  intPin: INT Output pin connection with Arduino, the INT will be pulled down when an object approaches
@@ -17,10 +20,13 @@ Others:
 **********************************************************/
 BM32S3021_1::BM32S3021_1(uint8_t intPin, HardwareSerial *theSerial)
 {
+#if BM32S3021_1_SOFTSERIAL
      _softSerial = NULL;
+#endif
      _intPin = intPin;
      _hardSerial = theSerial;
 }
+#if BM32S3021_1_SOFTSERIAL
 /**********************************************************
 Description: Constructor
 Parameters:  intPin: INT Output pin connection with Arduino, 
@@ -36,28 +42,185 @@ BM32S3021_1::BM32S3021_1(uint8_t intPin,uint8_t rxPin,uint8_t txPin)
     _intPin = intPin;
     _rxPin = rxPin;
     _txPin = txPin;
-    _softSerial = new SoftwareSerial(_rxPin,_txPin);
+    _softSerial = new BM32S3021_1_SoftSerial(_rxPin,_txPin);
+}
+
+#endif
+
+/**********************************************************
+Description: Destructor
+Parameters:          
+Return:          
+Others:      The INT interrupt must not call a destroyed object
+**********************************************************/
+BM32S3021_1::~BM32S3021_1()
+{
+    disableINTTimestamp();
 }
 
 /**********************************************************
 Description: Module Initial
 Parameters:  baudRate: Module communication baud rate(Unique 9600bps)        
+             probe: 1: probe the firmware capability once (see probeCapability())
+                    0: treat the module as the oldest firmware(Default)
 Return:          
 Others:   If the hardware UART is initialized, the _softSerial 
           pointer is null, otherwise it is non-null       
 **********************************************************/
-void BM32S3021_1::begin(uint16_t baud)
+void BM32S3021_1::begin(uint16_t baud, uint8_t probe)
 {
+#if BM32S3021_1_SOFTSERIAL
     if(_softSerial != NULL)
     {
         pinMode(_intPin,INPUT);
         _softSerial->begin(baud); 
     }
     else
+#endif
     {
         pinMode(_intPin,INPUT);
         _hardSerial->begin(baud);
     }
+#if BM32S3021_1_DIAGNOSTICS
+    if(probe)
+    {
+        probeCapability();
+    }
+#else
+    (void)probe;
+#endif
+}
+
+#if BM32S3021_1_DIAGNOSTICS
+/**********************************************************
+Description: Probe the firmware capability
+Parameters:          
+Return:      capability: 
+                        BM32S3021_1_CAP_BLOCK_READ  : multi-register read supported
+                        BM32S3021_1_CAP_BLOCK_WRITE : multi-register write supported
+                        BM32S3021_1_CAP_PROBED      : always set
+Others:      The minimum inter-command gap is measured first (see 
+             measureTurnaround()). The version is read with single 
+             reads and then with one block read. The gesture parameters are read 
+             and written back unchanged with one block write and 
+             verified by readback. If the block write is refused or 
+             the readback differs, the parameters read before are 
+             written back with single writes, so probing leaves the 
+             module configuration as it was. Unsupported commands 
+             leave the driver on the single register path.
+**********************************************************/
+uint8_t BM32S3021_1::probeCapability()
+{
+    uint8_t ver[2] = {0};
+#if BM32S3021_1_TUNING
+    uint8_t para[6] = {0};
+    uint8_t check[6] = {0};
+#endif
+    uint16_t singleVer = 0;
+    _capability = 0;
+    measureTurnaround();
+    singleVer = getFWVer();
+    if((readIrA0_A1(ver) == SUCCESS) && (singleVer == (ver[0] + (ver[1]<<8))))
+    {
+      _capability |= BM32S3021_1_CAP_BLOCK_READ;
+#if BM32S3021_1_TUNING
+      if(readIrA6_Ab(para) == SUCCESS)
+      {
+        if((writeIrA6_Ab(para) == SUCCESS)
+           && (readIrA6_Ab(check) == SUCCESS)
+           && (memcmp(para, check, 6) == 0))
+        {
+          _capability |= BM32S3021_1_CAP_BLOCK_WRITE;
+        }
+        else
+        {
+          setIRParameters(para);    //BLOCK_WRITE is clear: six single writes
+        }
+      }
+#endif
+    }
+    _capability |= BM32S3021_1_CAP_PROBED;
+    return _capability;
+}
+
+/**********************************************************
+Description: Measure the minimum inter-command gap of the module
+Parameters:          
+Return:      0:Success 1:Fail(the default gap is kept)
+Others:      Back-to-back version reads are issued with increasing 
+             gaps. The first gap where every reply is correct is 
+             doubled and 0.5ms is added as margin. A failed step 
+             is followed by the full default gap. The result only 
+             applies after reads, see writeBytes().
+**********************************************************/
+uint8_t BM32S3021_1::measureTurnaround()
+{
+    static const uint16_t gaps[5] = {0, 500, 1000, 2000, 5000};
+    uint8_t sendBuf[5] = {0x55, 0x80, 0x00, 0x01, 0xD6};
+    uint8_t buff[6] = {0};
+    uint8_t i = 0, n = 0;
+    for(i = 0; i < 5; i++)
+    {
+      _cmdGap = gaps[i];
+      for(n = 0; n < 4; n++)
+      {
+        writeBytes(sendBuf,5);
+        if(readBytes(buff,6) != CHECK_OK)
+        {
+          break;
+        }
+      }
+      if(n == 4)
+      {
+        _cmdGap = gaps[i] * 2 + 500;
+        return SUCCESS;
+      }
+      _holdOff = BM32S3021_1_DEFAULT_GAP;
+    }
+    _cmdGap = BM32S3021_1_DEFAULT_GAP;
+    return FAIL;
+}
+
+/**********************************************************
+Description: Get the cached firmware capability
+Parameters:          
+Return:      capability, 0 if probeCapability() has not been run  
+Others:      
+**********************************************************/
+uint8_t BM32S3021_1::getCapability()
+{
+    return _capability;
+}
+
+#endif
+
+/**********************************************************
+Description: Set the inter-command gap
+Parameters:  gapUs: minimum time from the last reply to the next 
+                    command, unit: us 
+                    parameter range: 0~65535 (Default 10000)
+Return:          
+Others:      The library has no table of gaps per firmware 
+             revision: the caller supplies the value, e.g. the 
+             getTurnaround() of a unit probed with probeCapability() 
+             on the same firmware, to skip measuring every unit. 
+             Commands that write the module are still followed by 
+             BM32S3021_1_DEFAULT_GAP
+**********************************************************/
+void BM32S3021_1::setTurnaround(uint16_t gapUs)
+{
+    _cmdGap = gapUs;
+}
+
+/**********************************************************
+Description: Get the inter-command gap
+Parameters:          
+Return:      minimum time from the last reply to the next command, unit: us
+Others:      
+**********************************************************/
+uint16_t BM32S3021_1::getTurnaround()
+{
+    return _cmdGap;
 }
 
 /**********************************************************
@@ -73,6 +236,103 @@ uint8_t BM32S3021_1::getINT()
      return (digitalRead(_intPin));
 }
 
+/**********************************************************
+Description: Enable INT edge timestamping
+Parameters:          
+Return:      0:Success 
+             1:Fail(intPin has no external interrupt, or all 
+               BM32S3021_1_MAX_INT_INSTANCES slots are in use)
+Others:      Call after begin(). The falling and rising edges of
+             INT are timestamped with micros() in an interrupt, 
+             and the timestamps are attached to every gesture 
+             decoded by getIRStatus()
+**********************************************************/
+uint8_t BM32S3021_1::enableINTTimestamp()
+{
+    uint8_t i = 0;
+    int irq = digitalPinToInterrupt(_intPin);
+    if(_intTimestamp)
+    {
+      return SUCCESS;
+    }
+    if(irq == NOT_AN_INTERRUPT)
+    {
+      return FAIL;
+    }
+    for(i = 0; i < BM32S3021_1_MAX_INT_INSTANCES; i++)
+    {
+      if(_intInstance[i] == NULL)
+      {
+        _intInstance[i] = this;
+        break;
+      }
+    }
+    if(i == BM32S3021_1_MAX_INT_INSTANCES)
+    {
+      return FAIL;
+    }
+    _intTimestamp = 1;
+    _intSlot = i;
+    attachInterrupt(irq, _intISR[i], CHANGE);
+    return SUCCESS;
+}
+
+/**********************************************************
+Description: Disable INT edge timestamping
+Parameters:          
+Return:      
+Others:      Detaches the INT interrupt and frees the slot, 
+             called by the destructor
+**********************************************************/
+void BM32S3021_1::disableINTTimestamp()
+{
+    if(!_intTimestamp)
+    {
+      return;
+    }
+    detachInterrupt(digitalPinToInterrupt(_intPin));
+    noInterrupts();
+    _intInstance[_intSlot] = NULL;
+    _intTimestamp = 0;
+    interrupts();
+}
+
+/**********************************************************
+Description: Get INT falling edge timestamp of the last gesture
+Parameters:          
+Return:      micros() value when INT was pulled down for the 
+             gesture last decoded by getIRStatus(), 
+             0 if timestamping is not enabled
+Others:      
+**********************************************************/
+uint32_t BM32S3021_1::getINTFallTime()
+{
+     return _gestureFallTime;
+}
+
+/**********************************************************
+Description: Get INT rising edge timestamp of the last gesture
+Parameters:          
+Return:      micros() value when INT was released for the 
+             gesture last decoded by getIRStatus(), 
+             0 if INT is still low or timestamping is not enabled
+Others:      getINTRiseTime()-getINTFallTime() is the INT low 
+             time of the gesture in us
+**********************************************************/
+uint32_t BM32S3021_1::getINTRiseTime()
+{
+    if(_intTimestamp && (_gestureRiseTime == 0))
+    {
+      noInterrupts();
+      if(_intFallTime == _gestureFallTime)
+      {
+        _gestureRiseTime = _intRiseTime;
+      }
+      interrupts();
+    }
+    return _gestureRiseTime;
+}
+
 /**********************************************************
 Description: Get IR Induction state
 Parameters:   
@@ -91,16 +351,27 @@ Others:
 **********************************************************/
 uint8_t BM32S3021_1::getIRStatus()
 {
-    uint8_t sendBuf[5] = {0x55, 0x80, 0x02, 0x01, 0xD8};
-    uint8_t buff[6] = {0};
     uint8_t  irStatus = 0;
-    writeBytes(sendBuf,5);
-    if(readBytes(buff,6)== CHECK_OK)
+    readIRStatus(&irStatus);
+    return irStatus;
+}
+
+/**********************************************************
+Description: Get IR status with the communication status
+Parameters:  irStatus: Stores the IR status, same bits as getIRStatus()
+                       0 if the read fails
+Return:      Communication status  0:Success 1:Fail   
+Others:      Use it when a failed read must not be taken as 
+             status 0
+**********************************************************/
+uint8_t BM32S3021_1::readIRStatus(uint8_t  *irStatus)
+{
+    if(readIrReg(0x02, irStatus) == SUCCESS)
     {
-     irStatus= buff[4];
+      latchINTTimestamp();
+      return SUCCESS;
     }
-    delay(10);
-    return irStatus;
+    return FAIL;
 }
 
 /**********************************************************
@@ -112,6 +383,20 @@ Others:      Place the object to be measured to the distance
              the learning
 **********************************************************/
 uint8_t BM32S3021_1::distanceLearning()
+{
+    uint8_t status = startDistanceLearning();
+    delay(BM32S3021_1_LEARN_TIME);
+    return status;
+}
+
+/**********************************************************
+Description: Start Distance Learning without waiting
+Parameters:         
+Return:      Communication status  0:Success 1:Fail   
+Others:      The learning completes BM32S3021_1_LEARN_TIME ms 
+             later, do not send commands to the module before
+**********************************************************/
+uint8_t BM32S3021_1::startDistanceLearning()
 {
     uint8_t sendBuf[3] = {0x55, 0x19, 0x6E};
     uint8_t buff[3] = {0};
@@ -120,14 +405,13 @@ uint8_t BM32S3021_1::distanceLearning()
     {
      if(buff[1]== 0x7f)
      {
-       delay(2000);
        return SUCCESS;
      }
     }
-    delay(2000);
     return FAIL ;
 }
 
+#if BM32S3021_1_DIAGNOSTICS
 /**********************************************************
 Description: Get number of left & right sliding
 Parameters:       
@@ -144,7 +428,6 @@ uint8_t BM32S3021_1::getIRGestureNum()
     {
      num= buff[4];
     }
-    delay(10);
     return num;
 }
 
@@ -162,22 +445,50 @@ uint16_t BM32S3021_1::getFWVer()
     uint8_t verh = 0;
     uint8_t verl = 0;
     uint16_t ver = 0;
+    if(_capability & BM32S3021_1_CAP_BLOCK_READ)
+    {
+      if(readIrA0_A1(buff) == SUCCESS)
+      {
+        ver = buff[0] + (buff[1]<<8);
+      }
+      return ver;
+    }
     writeBytes(sendBuf1,5);
     if(readBytes(buff,6)== CHECK_OK)
     {
     verl= buff[4];
     }
-    delay(10);
     writeBytes(sendBuf2,5);
    if(readBytes(buff,6)== CHECK_OK)
    {
     verh= buff[4];
    }  
     ver = verl+ (verh<<8);
-   delay(10);
    return ver;
 }
 
+/**********************************************************
+Description: Read IR1 and IR2 reference in one transaction
+Parameters:  buff[]: Stores the IR reference
+                     parameter range: The minimum array length is 2 bytes
+Return:      Communication status  0:Success 1:Fail
+Others:      buff[0] : IR1 Ref 
+             buff[1] : IR2 Ref
+**********************************************************/
+uint8_t BM32S3021_1::readIRRef(uint8_t  buff[])
+{
+    uint8_t rbuf[4] = {0};
+    if(readIrA2_A5(rbuf) == SUCCESS)
+    {
+      buff[0] = rbuf[2];
+      buff[1] = rbuf[3];
+      return SUCCESS;
+    }
+    return FAIL;
+}
+
+#endif
+
 /**********************************************************
 Description: Module reset
 Parameters:         
@@ -193,14 +504,13 @@ uint8_t BM32S3021_1::reset()
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
+#if BM32S3021_1_TUNING
 /**********************************************************
 Description: Get IR debounce value
 Parameters:    
@@ -217,7 +527,6 @@ uint8_t BM32S3021_1::getIRDebounce()
     {
      debounce= buff[4];
     }
-    delay(10);
     return debounce;
 }
 
@@ -237,7 +546,6 @@ uint8_t BM32S3021_1::getIRThreshold()
     {
      threshold = buff[4];
     }
-    delay(10);
     return threshold;
 }
 
@@ -258,7 +566,6 @@ uint8_t BM32S3021_1::getIRQTrigerTime()
     {
      irqTime = buff[4];
     }
-    delay(10);
     return irqTime;
 }
 
@@ -279,7 +586,6 @@ uint8_t BM32S3021_1::getIRContinutyGestureTime()
     {
      irqTime = buff[4];
     }
-    delay(10);
     return irqTime;
 }
 
@@ -300,7 +606,6 @@ uint8_t BM32S3021_1::getIRFastestGestureTime()
     {
      irqTime = buff[4];
     }
-    delay(10);
     return irqTime;
 }
 
@@ -321,7 +626,6 @@ uint8_t BM32S3021_1::getIRSlowestGestureTime()
     {
      irqTime = buff[4];
     }
-    delay(10);
     return irqTime;
 }
 
@@ -344,11 +648,9 @@ uint8_t BM32S3021_1::setIRDebounce(uint8_t  debounce)
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
@@ -370,11 +672,9 @@ uint8_t BM32S3021_1::setIRThreshold(uint8_t  threshold)
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
@@ -399,11 +699,9 @@ uint8_t BM32S3021_1::setIRQTrigerTime(uint8_t  irqTime)
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
@@ -426,11 +724,9 @@ uint8_t BM32S3021_1::setIRContinutyGestureTime(uint8_t  irTime)
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
@@ -453,11 +749,9 @@ uint8_t BM32S3021_1::setIRFastestGestureTime(uint8_t  irTime)
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
@@ -481,14 +775,68 @@ uint8_t BM32S3021_1::setIRSlowestGestureTime(uint8_t  irTime)
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
+/**********************************************************
+Description: Get all IR gesture parameters
+Parameters:  buff[]: Stores the IR gesture parameters
+                     parameter range: The minimum array length is 6 bytes
+Return:      Communication status  0:Success 1:Fail   
+Others:      buff[0] : IR Debounce  
+             buff[1] : IR Threshold
+             buff[2] : IRQ Triger Time 
+             buff[3] : Continuty Gersture Time
+             buff[4] : Fastest Gersture Time 
+             buff[5] : Slowest Gersture Time  
+             One block read if the firmware supports it, 
+             otherwise six single reads
+**********************************************************/
+uint8_t BM32S3021_1::getIRParameters(uint8_t  buff[])
+{
+    if(_capability & BM32S3021_1_CAP_BLOCK_READ)
+    {
+      return readIrA6_Ab(buff);
+    }
+    uint8_t status = SUCCESS;
+    uint8_t i = 0;
+    for(i = 0; i < 6; i++)
+    {
+      status |= readIrReg(0x06 + i, &buff[i]);
+    }
+    return status;
+}
+
+/**********************************************************
+Description: Set all IR gesture parameters
+Parameters:  buff[]: IR gesture parameters, same order as getIRParameters()
+                     parameter range: The minimum array length is 6 bytes
+Return:      Communication status  0:Success 1:Fail   
+Others:      One block write if the firmware supports it, 
+             otherwise six single writes
+**********************************************************/
+uint8_t BM32S3021_1::setIRParameters(uint8_t  buff[])
+{
+    uint8_t status = SUCCESS;
+    if(_capability & BM32S3021_1_CAP_BLOCK_WRITE)
+    {
+      return writeIrA6_Ab(buff);
+    }
+    status |= setIRDebounce(buff[0]);
+    status |= setIRThreshold(buff[1]);
+    status |= setIRQTrigerTime(buff[2]);
+    status |= setIRContinutyGestureTime(buff[3]);
+    status |= setIRFastestGestureTime(buff[4]);
+    status |= setIRSlowestGestureTime(buff[5]);
+    return status;
+}
+
+#endif
+
+#if BM32S3021_1_CALIBRATION
 /**********************************************************
 Description: Write the version information low byte
 Parameters:  verl: version information low byte
@@ -508,14 +856,15 @@ uint8_t BM32S3021_1::writeVerL(uint8_t  verl)
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
+#endif
+
+#if BM32S3021_1_DIAGNOSTICS
 /**********************************************************
 Description: Read IR1 reference
 Parameters: 
@@ -532,7 +881,6 @@ uint8_t BM32S3021_1::readIR1Ref()
     {
      ref= buff[4];
     }
-    delay(10);
     return ref;
 }
 /**********************************************************
@@ -551,10 +899,11 @@ uint8_t BM32S3021_1::readIR2Ref()
     {
      ref= buff[4];
     }
-    delay(10);
     return ref;
 }
 
+#endif
+
 /**********************************************************
 Description: Read IRStatus, IRGerstureNum, IR1Ref, IR2Ref value
 Parameters:  buff[]: Stores the IR partial state parameter
@@ -574,7 +923,6 @@ uint8_t BM32S3021_1::readIrA2_A5(uint8_t  buff[])
     writeBytes(sendBuf,5);
     if(readBytes(rbuf,9)== CHECK_OK)
     {
-     delay(10);
      buff[0] = rbuf[4];
      buff[1] = rbuf[5];
      buff[2] = rbuf[6];
@@ -584,6 +932,33 @@ uint8_t BM32S3021_1::readIrA2_A5(uint8_t  buff[])
     return FAIL;
 }
 
+/**********************************************************
+Description: Read one register
+Parameters:  addr: register address
+             value: Stores the register value, 0 if the read fails
+Return:     
+             0:Success 
+             1:Fail   
+Others:      Same transaction as the single getters, which 
+             return 0 on failure instead of a status
+**********************************************************/
+uint8_t BM32S3021_1::readIrReg(uint8_t  addr, uint8_t  *value)
+{
+    uint8_t sendBuf[5] = {0x55, 0x80, 0x00, 0x01, 0x00};
+    uint8_t buff[6] = {0};
+    sendBuf[2] = addr;
+    sendBuf[4] = 0xD6 + addr;
+    *value = 0;
+    writeBytes(sendBuf,5);
+    if(readBytes(buff,6)== CHECK_OK)
+    {
+     *value = buff[4];
+     return SUCCESS;
+    }
+    return FAIL;
+}
+
+#if BM32S3021_1_TUNING
 /**********************************************************
 Description: Read IRDebounce,IRThreshold,IRQTrigerTime,
              ContinutyGerstureTime,FastestGerstureTime,
@@ -607,7 +982,6 @@ uint8_t BM32S3021_1::readIrA6_Ab(uint8_t  buff[])
     writeBytes(sendBuf,5);
     if(readBytes(rbuf,11)== CHECK_OK)
     {
-     delay(10);
      buff[0] = rbuf[4];
      buff[1] = rbuf[5];
      buff[2] = rbuf[6];
@@ -619,6 +993,72 @@ uint8_t BM32S3021_1::readIrA6_Ab(uint8_t  buff[])
     return FAIL;
 }
 
+#endif
+
+#if BM32S3021_1_DIAGNOSTICS
+/**********************************************************
+Description: Read the version information in one transaction
+Parameters:  buff[]: Stores the version information
+                     parameter range: The minimum array length is 2 bytes
+Return:      
+             0:Success 
+             1:Fail   
+Others:      buff[0] : version low byte  
+             buff[1] : version high byte
+**********************************************************/
+uint8_t BM32S3021_1::readIrA0_A1(uint8_t  buff[])
+{
+    uint8_t sendBuf[5] = {0x55, 0x80, 0x00, 0x02, 0xD7};
+    uint8_t rbuf[7] ={0};
+    writeBytes(sendBuf,5);
+    if(readBytes(rbuf,7)== CHECK_OK)
+    {
+     buff[0] = rbuf[4];
+     buff[1] = rbuf[5];
+     return SUCCESS;
+    }
+    return FAIL;
+}
+
+#endif
+
+#if BM32S3021_1_TUNING
+/**********************************************************
+Description: Write IRDebounce,IRThreshold,IRQTrigerTime,
+             ContinutyGerstureTime,FastestGerstureTime,
+             SlowestGerstureTime value in one transaction
+Parameters:  buff[]: IR gesture parameters, same order as readIrA6_Ab()
+                     parameter range: The minimum array length is 6 bytes    
+Return:      Communication status  0:Success 1:Fail   
+Others:      
+**********************************************************/
+uint8_t BM32S3021_1::writeIrA6_Ab(uint8_t  buff[])
+{
+    uint8_t sendBuf[11] = {0x55, 0xC0, 0x06, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    uint8_t rbuf[3] = {0};
+    uint8_t i = 0;
+    for(i = 0; i < 6; i++)
+    {
+      sendBuf[4+i] = buff[i];
+    }
+    for(i = 0; i < 10; i++)
+    {
+      sendBuf[10] += sendBuf[i];
+    }
+    writeBytes(sendBuf,11);
+    if(readBytes(rbuf,3)== CHECK_OK)
+    {
+     if(rbuf[1]== 0x7f)
+     {
+       return SUCCESS;
+     }
+    }
+    return FAIL;
+}
+
+#endif
+
+#if BM32S3021_1_CALIBRATION
 /**********************************************************
 Description: Get IR OPA 
 Parameters:        
@@ -635,7 +1075,6 @@ uint8_t BM32S3021_1::getIROPA()
     {
      opa = buff[4];
     }
-    delay(10);
     return opa;
 }
 
@@ -656,7 +1095,6 @@ uint8_t BM32S3021_1::getIR1Current()
     {
      current = buff[4];
     }
-    delay(10);
     return current;
 }
 
@@ -676,7 +1114,6 @@ uint8_t BM32S3021_1::getIR2Current()
     {
      current = buff[4];
     }
-    delay(10);
     return current;
 }
 
@@ -699,11 +1136,9 @@ uint8_t BM32S3021_1::setIROPA(uint8_t  opa)
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
@@ -727,11 +1162,9 @@ uint8_t BM32S3021_1::setIR1Current(uint8_t  current)
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
@@ -755,23 +1188,50 @@ uint8_t BM32S3021_1::setIR2Current(uint8_t  current)
     {
      if(buff[1]== 0x7f)
      {
-       delay(10);
        return SUCCESS;
      }
     }
-    delay(10);
     return FAIL ;
 }
 
+#endif
+
+/**********************************************************
+Description: Wait until the inter-command gap has passed
+Parameters:  
+Return:   
+Others:      Measured from the end of the last reply, so the wait 
+             is skipped when the sketch spent the time elsewhere
+**********************************************************/
+void BM32S3021_1::waitTurnaround()
+{
+  uint32_t gap = (_holdOff > _cmdGap) ? _holdOff : _cmdGap;
+  uint32_t elapsed = micros() - _lastReplyTime;
+  _holdOff = 0;
+  if (elapsed < gap)
+  {
+    gap -= elapsed;
+    if (gap >= 1000)
+    {
+      delay(gap / 1000);
+    }
+    delayMicroseconds(gap % 1000);
+  }
+}
+
 /**********************************************************
 Description: writeBytes
 Parameters:  wbuf[]:Variables for storing Data to be sent
              wlen:Length of data sent  
 Return:   
-Others:
+Others:      Only reads are measured by measureTurnaround(), so 
+             every other command (register write, reset, distance 
+             learning) is followed by the full default gap
 **********************************************************/
 void BM32S3021_1::writeBytes(uint8_t wbuf[], uint8_t wlen)
 {
+  waitTurnaround();
+#if BM32S3021_1_SOFTSERIAL
   /* Select SoftwareSerial Interface */
   if (_softSerial != NULL)
   {
@@ -780,9 +1240,14 @@ void BM32S3021_1::writeBytes(uint8_t wbuf[], uint8_t wlen)
       _softSerial->read();
     }
     _softSerial->write(wbuf, wlen);
+#if BM32S3021_1_TIMERSERIAL
+    /* The frame is shifted out by the timer interrupt, wait for the last stop bit before the reply timeout starts */
+    _softSerial->flush();
+#endif
   }
   /* Select HardwareSerial Interface */
   else
+#endif
   {
     while (_hardSerial->available() > 0)
     {
@@ -790,18 +1255,29 @@ void BM32S3021_1::writeBytes(uint8_t wbuf[], uint8_t wlen)
     }
     _hardSerial->write(wbuf, wlen);
   }
+  if (wbuf[1] != 0x80)
+  {
+    _holdOff = BM32S3021_1_DEFAULT_GAP;   // Not a read, the measured gap does not apply
+  }
 }
 
 /**********************************************************
 Description: readBytes
 Parameters:  rbuf[]:Variables for storing Data to be obtained
              rlen:Length of data to be obtained
+             timeOut:Wait time of each byte, unit: ms
 Return:   
-Others:
+Others:      The end of the reply is the reference of the next 
+             inter-command gap. Polls every 0.1ms on bare-metal 
+             cores; on ESP32 every 1ms with delay(), so the 
+             BM32S3021_1_Task driver task does not starve the 
+             other tasks of its core while it waits
 **********************************************************/
 uint8_t BM32S3021_1::readBytes(uint8_t rbuf[], uint8_t rlen, uint16_t timeOut)
 {
-  uint8_t i = 0, delayCnt = 0, checkSum = 0;
+  uint8_t i = 0, checkSum = 0;
+  uint16_t delayCnt = 0;
+#if BM32S3021_1_SOFTSERIAL
 /* Select SoftwareSerial Interface */
   if (_softSerial != NULL)
   {
@@ -810,11 +1286,12 @@ uint8_t BM32S3021_1::readBytes(uint8_t rbuf[], uint8_t rlen, uint16_t timeOut)
       delayCnt = 0;
       while (_softSerial->available() == 0)
       {
-        if (delayCnt > timeOut)
+        if (delayCnt > timeOut * (1000 / BM32S3021_1_POLL_US))
         {
+          _lastReplyTime = micros();
           return TIMEOUT_ERROR; // Timeout error
         }
-        delay(1);
+        BM32S3021_1_POLL_WAIT();   // Short poll so a byte is not left waiting in the buffer
         delayCnt++;
       }
       rbuf[i] = _softSerial->read();
@@ -822,23 +1299,27 @@ uint8_t BM32S3021_1::readBytes(uint8_t rbuf[], uint8_t rlen, uint16_t timeOut)
   }
 /* Select HardwareSerial Interface */
   else
+#endif
   {
     for (i = 0; i < rlen; i++)
     {
       delayCnt = 0;
       while (_hardSerial->available() == 0)
       {
-        if (delayCnt > timeOut)
+        if (delayCnt > timeOut * (1000 / BM32S3021_1_POLL_US))
         {
+          _lastReplyTime = micros();
           return TIMEOUT_ERROR; // Timeout error
         }
-        delay(1);
+        BM32S3021_1_POLL_WAIT();   // Short poll so a byte is not left waiting in the buffer
         delayCnt++;
       }
       rbuf[i] = _hardSerial->read();
     }
   }
 
+  _lastReplyTime = micros();
+
   /* check Sum */
   for (i = 0; i < (rlen - 1); i++)
   {
@@ -853,3 +1334,57 @@ uint8_t BM32S3021_1::readBytes(uint8_t rbuf[], uint8_t rlen, uint16_t timeOut)
     return CHECK_ERROR; // Check error
   }
 }
+
+/**********************************************************
+Description: Attach the INT edge timestamps to the decoded gesture
+Parameters:  
+Return:   
+Others:      The rising edge timestamp is 0 while INT is still low
+**********************************************************/
+void BM32S3021_1::latchINTTimestamp()
+{
+  if (_intTimestamp)
+  {
+    noInterrupts();
+    _gestureFallTime = _intFallTime;
+    _gestureRiseTime = _intRiseTime;
+    interrupts();
+  }
+}
+
+/**********************************************************
+Description: INT edge interrupt handler
+Parameters:  
+Return:   
+Others:      Falling edge: store the start time and clear the 
+             rising edge time until INT is released
+**********************************************************/
+BM32S3021_1_ISR_ATTR void BM32S3021_1::intEdgeHandler()
+{
+  uint32_t now = micros();
+  if (digitalRead(_intPin) == LOW)
+  {
+    _intFallTime = now;
+    _intRiseTime = 0;
+  }
+  else
+  {
+    _intRiseTime = now;
+  }
+}
+
+/**********************************************************
+Description: INT interrupt entry of each timestamping slot
+Parameters:  
+Return:   
+Others:
+**********************************************************/
+BM32S3021_1_ISR_ATTR void BM32S3021_1::intISR0()
+{
+  _intInstance[0]->intEdgeHandler();
+}
+
+BM32S3021_1_ISR_ATTR void BM32S3021_1::intISR1()
+{
+  _intInstance[1]->intEdgeHandler();
+}
@@ -8,7 +8,35 @@ Version:          V1.0.4   -- 2025-03-13
 #define _BM32S3021_1_H_
 
 #include "Arduino.h"
+
+/* Feature switches: build with -D<switch>=0 (e.g. build_flags in 
+   platformio.ini or compiler.cpp.extra_flags in arduino-cli) to 
+   leave the unused parts out of small boards */
+#ifndef BM32S3021_1_TUNING
+#define BM32S3021_1_TUNING        1   //Gesture parameter getters/setters
+#endif
+#ifndef BM32S3021_1_CALIBRATION
+#define BM32S3021_1_CALIBRATION   1   //IR emission current/OPA calibration
+#endif
+#ifndef BM32S3021_1_DIAGNOSTICS
+#define BM32S3021_1_DIAGNOSTICS   1   //Version, gesture count, IR reference and capability probing
+#endif
+#ifndef BM32S3021_1_SOFTSERIAL
+#define BM32S3021_1_SOFTSERIAL    1   //intPin/rxPin/txPin constructor
+#endif
+#ifndef BM32S3021_1_TIMERSERIAL
+#define BM32S3021_1_TIMERSERIAL   0   //rxPin/txPin use the Timer2 driven UART instead of SoftwareSerial(AVR only)
+#endif
+
+#if BM32S3021_1_SOFTSERIAL
+#if BM32S3021_1_TIMERSERIAL
+#include "BM32S3021-1_TimerSerial.h"
+typedef BM32S3021_1_TimerSerial BM32S3021_1_SoftSerial;
+#else
 #include <SoftwareSerial.h>
+typedef SoftwareSerial BM32S3021_1_SoftSerial;
+#endif
+#endif
 
 #define   SUCCESS         0
 #define   FAIL            1
@@ -16,21 +44,66 @@ Version:          V1.0.4   -- 2025-03-13
 #define CHECK_ERROR     1
 #define TIMEOUT_ERROR   2
 
+#define BM32S3021_1_CAP_BLOCK_READ    0x01   //Multi-register read of any address range
+#define BM32S3021_1_CAP_BLOCK_WRITE   0x02   //Multi-register write of the gesture parameters
+#define BM32S3021_1_CAP_PROBED        0x80   //probeCapability() has been run
+
+#define BM32S3021_1_LEARN_TIME        2000   //Distance learning time, unit: ms
+#define BM32S3021_1_DEFAULT_GAP       10000  //Inter-command gap of unprobed modules, unit: us
+
+#define BM32S3021_1_MAX_INT_INSTANCES   2   //Number of modules that can timestamp INT edges at the same time
+static_assert(BM32S3021_1_MAX_INT_INSTANCES == 2, "add an intISRn entry to _intISR[] for each INT slot");
+
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266)
+#define BM32S3021_1_ISR_ATTR   IRAM_ATTR
+#else
+#define BM32S3021_1_ISR_ATTR
+#endif
+
+/* Reply byte polling: delay() yields to other FreeRTOS tasks, 
+   delayMicroseconds() spins, so RTOS builds poll every 1ms */
+#if defined(ARDUINO_ARCH_ESP32)
+#define BM32S3021_1_POLL_US      1000
+#define BM32S3021_1_POLL_WAIT()  delay(1)
+#else
+#define BM32S3021_1_POLL_US      100
+#define BM32S3021_1_POLL_WAIT()  delayMicroseconds(100)
+#endif
+
 
 class BM32S3021_1
 {
   public:
     BM32S3021_1(uint8_t intPin, HardwareSerial *theSerial  = &Serial);
+#if BM32S3021_1_SOFTSERIAL
     BM32S3021_1(uint8_t intPin,uint8_t rxPin,uint8_t txPin);
-    void begin(uint16_t baud = 9600);
+#endif
+    ~BM32S3021_1();
+    void begin(uint16_t baud = 9600, uint8_t probe = 0);
+#if BM32S3021_1_DIAGNOSTICS
+    uint8_t probeCapability();
+    uint8_t getCapability();
+#endif
+    void setTurnaround(uint16_t gapUs);
+    uint16_t getTurnaround();
    
     uint8_t getINT();
+    uint8_t enableINTTimestamp();
+    void disableINTTimestamp();
+    uint32_t getINTFallTime();
+    uint32_t getINTRiseTime();
     uint8_t getIRStatus();
+    uint8_t readIRStatus(uint8_t  *irStatus);
     uint8_t distanceLearning();
+    uint8_t startDistanceLearning();
+#if BM32S3021_1_DIAGNOSTICS
     uint8_t getIRGestureNum();
     uint16_t getFWVer();
+    uint8_t readIRRef(uint8_t  buff[]);
+#endif
     uint8_t reset();
    
+#if BM32S3021_1_TUNING
     uint8_t getIRDebounce();
     uint8_t getIRThreshold();
     uint8_t getIRQTrigerTime();
@@ -43,26 +116,58 @@ class BM32S3021_1
     uint8_t setIRContinutyGestureTime(uint8_t  irTime = 30);
     uint8_t setIRFastestGestureTime(uint8_t  irTime = 0);
     uint8_t setIRSlowestGestureTime(uint8_t  irTime = 80);
+    uint8_t getIRParameters(uint8_t  buff[]);
+    uint8_t setIRParameters(uint8_t  buff[]);
+#endif
  
   private:
-    uint8_t writeVerL(uint8_t  verl);
+#if BM32S3021_1_DIAGNOSTICS
     uint8_t readIR1Ref();
     uint8_t readIR2Ref();
+    uint8_t readIrA0_A1(uint8_t  buff[]);
+    uint8_t measureTurnaround();
+#endif
     uint8_t readIrA2_A5(uint8_t  buff[]);
+    uint8_t readIrReg(uint8_t  addr, uint8_t  *value);
+#if BM32S3021_1_TUNING
     uint8_t readIrA6_Ab(uint8_t  buff[]);
+    uint8_t writeIrA6_Ab(uint8_t  buff[]);
+#endif
+#if BM32S3021_1_CALIBRATION
+    uint8_t writeVerL(uint8_t  verl);
     uint8_t getIROPA();
     uint8_t getIR1Current();
     uint8_t getIR2Current();
     uint8_t setIROPA(uint8_t  value = 23); 
     uint8_t setIR1Current(uint8_t  current = 25);
     uint8_t setIR2Current(uint8_t  current = 25);
+#endif
+    void waitTurnaround();
     void writeBytes(uint8_t wbuf[], uint8_t wlen);
     uint8_t readBytes(uint8_t rbuf[], uint8_t rlen, uint16_t timeOut = 10);
+    void latchINTTimestamp();
+    void intEdgeHandler();
+    static void intISR0();
+    static void intISR1();
+    static BM32S3021_1 *_intInstance[BM32S3021_1_MAX_INT_INSTANCES];
+    static void (* const _intISR[BM32S3021_1_MAX_INT_INSTANCES])();
+    volatile uint32_t _intFallTime = 0;
+    volatile uint32_t _intRiseTime = 0;
+    uint32_t _gestureFallTime = 0;
+    uint32_t _gestureRiseTime = 0;
+    uint8_t _intTimestamp = 0;
+    uint8_t _intSlot = 0;
+    uint8_t _capability = 0;
+    uint32_t _lastReplyTime = 0;
+    uint16_t _cmdGap = BM32S3021_1_DEFAULT_GAP;
+    uint16_t _holdOff = 0;
     uint16_t _intPin;
+    HardwareSerial *_hardSerial = NULL;
+#if BM32S3021_1_SOFTSERIAL
     uint16_t _rxPin;
     uint16_t _txPin;
-    HardwareSerial *_hardSerial = NULL;
-    SoftwareSerial *_softSerial = NULL ;   
+    BM32S3021_1_SoftSerial *_softSerial = NULL ;   
+#endif
 };
 
 #endif
@@ -0,0 +1,143 @@
+/*****************************************************************
+File:             BM32S3021-1_Fusion.cpp
+Author:           BEST MODULES CORP.
+Description:      Resolve four-direction and diagonal swipes from two
+                  BM32S3021_1 mounted at 90°
+Version:          V1.0.4   -- 2025-03-13
+Others:           Fixed size state, no allocation and a bounded amount
+                  of work per update()/poll()
+******************************************************************/
+#include "BM32S3021-1_Fusion.h"
+
+/**********************************************************
+Description: Constructor
+Parameters:  windowUs: swipes of both axes closer than this are 
+                       one diagonal swipe, unit: us (Default 150ms)
+Return:          
+Others:     
+**********************************************************/
+BM32S3021_1_Fusion::BM32S3021_1_Fusion(uint32_t windowUs)
+{
+    _window = windowUs;
+    _invert[0] = 0;
+    _invert[1] = 0;
+    clear();
+}
+
+/**********************************************************
+Description: Set the fusion time window
+Parameters:  windowUs: unit: us
+Return:          
+Others:     
+**********************************************************/
+void BM32S3021_1_Fusion::setWindow(uint32_t windowUs)
+{
+    _window = windowUs;
+}
+
+/**********************************************************
+Description: Swap the two directions of one axis
+Parameters:  axis: BM32S3021_1_AXIS_X or BM32S3021_1_AXIS_Y
+             invert: 1: the module is mounted the other way round
+Return:          
+Others:     
+**********************************************************/
+void BM32S3021_1_Fusion::setAxisInvert(uint8_t axis, uint8_t invert)
+{
+    _invert[axis & 0x01] = invert;
+}
+
+/**********************************************************
+Description: Feed the status of one module
+Parameters:  axis: BM32S3021_1_AXIS_X or BM32S3021_1_AXIS_Y
+             irStatus: value of BM32S3021_1::getIRStatus()
+             timeUs: time of the swipe, use getINTFallTime() if 
+                     INT timestamping is enabled, otherwise micros()
+Return:          
+Others:      Status without a swipe and repeated reads of the 
+             pending swipe of an axis (same timeUs) are ignored. A new 
+             swipe on an axis replaces the pending one.
+**********************************************************/
+void BM32S3021_1_Fusion::update(uint8_t axis, uint8_t irStatus, uint32_t timeUs)
+{
+    uint8_t swipe = BM32S3021_1_SWIPE_NONE;
+    axis &= 0x01;
+    if((irStatus & 0x08) || !(irStatus & 0x06))
+    {
+      return;
+    }
+    if((_swipe[axis] != BM32S3021_1_SWIPE_NONE) && (_time[axis] == timeUs))
+    {
+      return;
+    }
+    if((irStatus & 0x02) != 0)
+    {
+      swipe = _invert[axis] ? BM32S3021_1_SWIPE_LEFT : BM32S3021_1_SWIPE_RIGHT;
+    }
+    else
+    {
+      swipe = _invert[axis] ? BM32S3021_1_SWIPE_RIGHT : BM32S3021_1_SWIPE_LEFT;
+    }
+    if(axis == BM32S3021_1_AXIS_Y)
+    {
+      swipe = (swipe == BM32S3021_1_SWIPE_RIGHT) ? BM32S3021_1_SWIPE_UP : BM32S3021_1_SWIPE_DOWN;
+    }
+    _swipe[axis] = swipe;
+    _time[axis] = timeUs;
+}
+
+/**********************************************************
+Description: Get the resolved swipe
+Parameters:  nowUs: micros()
+Return:      BM32S3021_1_SWIPE_NONE: nothing resolved yet
+             otherwise BM32S3021_1_SWIPE_xxx, diagonals have one 
+             X bit and one Y bit set
+Others:      A swipe is resolved once the window after the earliest
+             pending swipe has passed. The other axis is merged if its
+             swipe is inside the window, otherwise it stays pending.
+**********************************************************/
+uint8_t BM32S3021_1_Fusion::poll(uint32_t nowUs)
+{
+    uint8_t first = 0;
+    uint8_t other = 0;
+    uint8_t swipe = BM32S3021_1_SWIPE_NONE;
+    if((_swipe[0] == BM32S3021_1_SWIPE_NONE) && (_swipe[1] == BM32S3021_1_SWIPE_NONE))
+    {
+      return BM32S3021_1_SWIPE_NONE;
+    }
+    if(_swipe[0] == BM32S3021_1_SWIPE_NONE)
+    {
+      first = 1;
+    }
+    else if((_swipe[1] != BM32S3021_1_SWIPE_NONE) && ((int32_t)(_time[1] - _time[0]) < 0))
+    {
+      first = 1;
+    }
+    other = first ^ 0x01;
+    if((uint32_t)(nowUs - _time[first]) < _window)
+    {
+      return BM32S3021_1_SWIPE_NONE;
+    }
+    swipe = _swipe[first];
+    _swipe[first] = BM32S3021_1_SWIPE_NONE;
+    if((_swipe[other] != BM32S3021_1_SWIPE_NONE) && ((uint32_t)(_time[other] - _time[first]) <= _window))
+    {
+      swipe |= _swipe[other];
+      _swipe[other] = BM32S3021_1_SWIPE_NONE;
+    }
+    return swipe;
+}
+
+/**********************************************************
+Description: Drop the pending swipes
+Parameters:  
+Return:          
+Others:     
+**********************************************************/
+void BM32S3021_1_Fusion::clear()
+{
+    _swipe[0] = BM32S3021_1_SWIPE_NONE;
+    _swipe[1] = BM32S3021_1_SWIPE_NONE;
+    _time[0] = 0;
+    _time[1] = 0;
+}
@@ -0,0 +1,39 @@
+/*****************************************************************
+File:             BM32S3021-1_Fusion.h
+Author:           BEST MODULES CORP.
+Description:      Resolve four-direction and diagonal swipes from two
+                  BM32S3021_1 mounted at 90°
+Version:          V1.0.4   -- 2025-03-13
+******************************************************************/
+#ifndef _BM32S3021_1_FUSION_H_
+#define _BM32S3021_1_FUSION_H_
+
+#include "Arduino.h"
+
+#define BM32S3021_1_AXIS_X          0     //Module whose right swipe is "right"
+#define BM32S3021_1_AXIS_Y          1     //Module whose right swipe is "up"
+
+#define BM32S3021_1_SWIPE_NONE      0x00
+#define BM32S3021_1_SWIPE_LEFT      0x01
+#define BM32S3021_1_SWIPE_RIGHT     0x02
+#define BM32S3021_1_SWIPE_UP        0x04
+#define BM32S3021_1_SWIPE_DOWN      0x08  //Diagonals are UP/DOWN | LEFT/RIGHT
+
+class BM32S3021_1_Fusion
+{
+  public:
+    BM32S3021_1_Fusion(uint32_t windowUs = 150000);
+    void setWindow(uint32_t windowUs);
+    void setAxisInvert(uint8_t axis, uint8_t invert);
+    void update(uint8_t axis, uint8_t irStatus, uint32_t timeUs);
+    uint8_t poll(uint32_t nowUs);
+    void clear();
+
+  private:
+    uint32_t _window;
+    uint8_t _invert[2];
+    uint8_t _swipe[2];
+    uint32_t _time[2];
+};
+
+#endif
@@ -0,0 +1,209 @@
+/*****************************************************************
+File:             BM32S3021-1_OS.cpp
+Author:           BEST MODULES CORP.
+Description:      Queue, signal and thread shim used by BM32S3021_1_Task:
+                  FreeRTOS on ESP32, std::thread on a host build
+Version:          V1.0.4   -- 2025-03-13
+******************************************************************/
+#include "BM32S3021-1.h"
+#include "BM32S3021-1_OS.h"
+
+#if BM32S3021_1_OS
+
+#if !BM32S3021_1_OS_FREERTOS
+#include <chrono>
+#include <system_error>
+#include <thread>
+#endif
+
+/**********************************************************
+Description: Destructor
+Parameters:
+Return:
+Others:
+**********************************************************/
+BM32S3021_1_Queue::~BM32S3021_1_Queue()
+{
+#if BM32S3021_1_OS_FREERTOS
+    if(_handle != NULL)
+    {
+      vQueueDelete(_handle);
+    }
+#endif
+}
+
+/**********************************************************
+Description: Allocate the queue
+Parameters:  len: number of items
+             itemSize: size of one item, unit: byte
+Return:      0:Success 1:Fail
+Others:      Items are copied in and out
+**********************************************************/
+uint8_t BM32S3021_1_Queue::create(uint8_t len, uint8_t itemSize)
+{
+#if BM32S3021_1_OS_FREERTOS
+    _handle = xQueueCreate(len, itemSize);
+    return (_handle != NULL) ? SUCCESS : FAIL;
+#else
+    std::lock_guard<std::mutex> guard(_lock);
+    _buf.resize((size_t)len * itemSize);
+    _len = len;
+    _itemSize = itemSize;
+    _head = 0;
+    _count = 0;
+    return SUCCESS;
+#endif
+}
+
+/**********************************************************
+Description: Copy an item to the back of the queue
+Parameters:  item: item to be queued
+             timeOut: wait time while the queue is full, unit: ms
+                      BM32S3021_1_OS_FOREVER: no timeout
+Return:      0:Success 1:Fail(still full)
+Others:
+**********************************************************/
+uint8_t BM32S3021_1_Queue::send(const void *item, uint32_t timeOut)
+{
+#if BM32S3021_1_OS_FREERTOS
+    TickType_t ticks = (timeOut == BM32S3021_1_OS_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeOut);
+    return (xQueueSend(_handle, item, ticks) == pdTRUE) ? SUCCESS : FAIL;
+#else
+    std::unique_lock<std::mutex> guard(_lock);
+    if(timeOut == BM32S3021_1_OS_FOREVER)
+    {
+      _changed.wait(guard, [this]{ return _count < _len; });
+    }
+    else if(!_changed.wait_for(guard, std::chrono::milliseconds(timeOut), [this]{ return _count < _len; }))
+    {
+      return FAIL;
+    }
+    memcpy(&_buf[(size_t)((_head + _count) % _len) * _itemSize], item, _itemSize);
+    _count++;
+    _changed.notify_all();
+    return SUCCESS;
+#endif
+}
+
+/**********************************************************
+Description: Copy an item from the front of the queue
+Parameters:  item: Stores the item
+             timeOut: wait time while the queue is empty, unit: ms
+                      BM32S3021_1_OS_FOREVER: no timeout
+Return:      0:Success 1:Fail(still empty)
+Others:
+**********************************************************/
+uint8_t BM32S3021_1_Queue::receive(void *item, uint32_t timeOut)
+{
+#if BM32S3021_1_OS_FREERTOS
+    TickType_t ticks = (timeOut == BM32S3021_1_OS_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeOut);
+    return (xQueueReceive(_handle, item, ticks) == pdTRUE) ? SUCCESS : FAIL;
+#else
+    std::unique_lock<std::mutex> guard(_lock);
+    if(timeOut == BM32S3021_1_OS_FOREVER)
+    {
+      _changed.wait(guard, [this]{ return _count > 0; });
+    }
+    else if(!_changed.wait_for(guard, std::chrono::milliseconds(timeOut), [this]{ return _count > 0; }))
+    {
+      return FAIL;
+    }
+    memcpy(item, &_buf[(size_t)_head * _itemSize], _itemSize);
+    _head = (_head + 1) % _len;
+    _count--;
+    _changed.notify_all();
+    return SUCCESS;
+#endif
+}
+
+/**********************************************************
+Description: Constructor
+Parameters:
+Return:
+Others:      Binary signal, not given. It needs no allocation,
+             so it can live on the stack of the waiting task
+**********************************************************/
+BM32S3021_1_Signal::BM32S3021_1_Signal()
+{
+#if BM32S3021_1_OS_FREERTOS
+    _handle = xSemaphoreCreateBinaryStatic(&_buf);
+#endif
+}
+
+/**********************************************************
+Description: Destructor
+Parameters:
+Return:
+Others:
+**********************************************************/
+BM32S3021_1_Signal::~BM32S3021_1_Signal()
+{
+#if BM32S3021_1_OS_FREERTOS
+    vSemaphoreDelete(_handle);
+#endif
+}
+
+/**********************************************************
+Description: Wake the task waiting in take()
+Parameters:
+Return:
+Others:      The waiting task may destroy the signal as soon as
+             it wakes, nothing is touched after the wake-up
+**********************************************************/
+void BM32S3021_1_Signal::give()
+{
+#if BM32S3021_1_OS_FREERTOS
+    xSemaphoreGive(_handle);
+#else
+    std::lock_guard<std::mutex> guard(_lock);
+    _set = 1;
+    _given.notify_one();
+#endif
+}
+
+/**********************************************************
+Description: Wait until give() is called
+Parameters:
+Return:
+Others:
+**********************************************************/
+void BM32S3021_1_Signal::take()
+{
+#if BM32S3021_1_OS_FREERTOS
+    xSemaphoreTake(_handle, portMAX_DELAY);
+#else
+    std::unique_lock<std::mutex> guard(_lock);
+    _given.wait(guard, [this]{ return _set != 0; });
+    _set = 0;
+#endif
+}
+
+/**********************************************************
+Description: Start a thread that never returns
+Parameters:  entry: thread function
+             param: parameter of entry
+             stack: stack size, unit: byte (FreeRTOS only)
+             priority: task priority (FreeRTOS only)
+Return:      0:Success 1:Fail
+Others:
+**********************************************************/
+uint8_t BM32S3021_1_startThread(void (*entry)(void *), void *param, uint32_t stack, BM32S3021_1_Priority priority)
+{
+#if BM32S3021_1_OS_FREERTOS
+    return (xTaskCreate(entry, "BM32S3021_1", stack, param, priority, NULL) == pdPASS) ? SUCCESS : FAIL;
+#else
+    (void)stack;
+    (void)priority;
+    try
+    {
+      std::thread(entry, param).detach();
+    }
+    catch(const std::system_error &)
+    {
+      return FAIL;
+    }
+    return SUCCESS;
+#endif
+}
+
+#endif
@@ -0,0 +1,81 @@
+/*****************************************************************
+File:             BM32S3021-1_OS.h
+Author:           BEST MODULES CORP.
+Description:      Queue, signal and thread shim used by BM32S3021_1_Task:
+                  FreeRTOS on ESP32, std::thread on a host build
+Version:          V1.0.4   -- 2025-03-13
+******************************************************************/
+#ifndef _BM32S3021_1_OS_H_
+#define _BM32S3021_1_OS_H_
+
+#include "Arduino.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#define BM32S3021_1_OS            1
+#define BM32S3021_1_OS_FREERTOS   1
+typedef UBaseType_t BM32S3021_1_Priority;
+#elif !defined(ARDUINO)
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#define BM32S3021_1_OS            1
+#define BM32S3021_1_OS_FREERTOS   0
+typedef int BM32S3021_1_Priority;          //Ignored on a host build
+#else
+#define BM32S3021_1_OS            0
+#endif
+
+#if BM32S3021_1_OS
+
+#define BM32S3021_1_OS_FOREVER    0xFFFFFFFF   //Wait time without timeout
+
+class BM32S3021_1_Queue
+{
+  public:
+    ~BM32S3021_1_Queue();
+    uint8_t create(uint8_t len, uint8_t itemSize);
+    uint8_t send(const void *item, uint32_t timeOut);
+    uint8_t receive(void *item, uint32_t timeOut);
+
+  private:
+#if BM32S3021_1_OS_FREERTOS
+    QueueHandle_t _handle = NULL;
+#else
+    std::mutex _lock;
+    std::condition_variable _changed;
+    std::vector<uint8_t> _buf;
+    uint8_t _len = 0;
+    uint8_t _itemSize = 0;
+    uint8_t _head = 0;
+    uint8_t _count = 0;
+#endif
+};
+
+class BM32S3021_1_Signal
+{
+  public:
+    BM32S3021_1_Signal();
+    ~BM32S3021_1_Signal();
+    void give();
+    void take();
+
+  private:
+#if BM32S3021_1_OS_FREERTOS
+    StaticSemaphore_t _buf;
+    SemaphoreHandle_t _handle;
+#else
+    std::mutex _lock;
+    std::condition_variable _given;
+    uint8_t _set = 0;
+#endif
+};
+
+uint8_t BM32S3021_1_startThread(void (*entry)(void *), void *param, uint32_t stack, BM32S3021_1_Priority priority);
+
+#endif
+
+#endif
@@ -0,0 +1,231 @@
+/*****************************************************************
+File:             BM32S3021-1_Provision.cpp
+Author:           BEST MODULES CORP.
+Description:      End-of-line provisioning of several BM32S3021_1 on
+                  separate UARTs: configure, calibrate and verify with
+                  the 2s distance learning of all units overlapped
+Version:          V1.0.4   -- 2025-03-13
+Others:           Each unit runs reset, capability probe, parameter
+                  block write, block readback check, version check,
+                  distance learning and calibration check. run() does
+                  one step per unit and never waits for the learning
+                  time, so all units learn at the same time. Most steps
+                  are one transaction; the probe step runs the whole
+                  probeCapability() sequence (turnaround measurement,
+                  version reads and block write check, up to about 30
+                  transactions), and configure/readback fall back to
+                  six single transactions without block access.
+******************************************************************/
+#include "BM32S3021-1_Provision.h"
+
+#if BM32S3021_1_TUNING && BM32S3021_1_DIAGNOSTICS
+
+/**********************************************************
+Description: Constructor
+Parameters:  
+Return:          
+Others:     
+**********************************************************/
+BM32S3021_1_Provision::BM32S3021_1_Provision()
+{
+    uint8_t i = 0;
+    for(i = 0; i < BM32S3021_1_PROVISION_UNITS; i++)
+    {
+      _unit[i] = NULL;
+      _step[i] = BM32S3021_1_STEP_DONE;
+      _result[i] = BM32S3021_1_PROVISION_IDLE;
+    }
+}
+
+/**********************************************************
+Description: Add a unit to the fixture
+Parameters:  unit: module on its own UART, begin() must have been called
+Return:      index of the unit: 0~BM32S3021_1_PROVISION_UNITS-1, 
+             0xFF if the fixture is full
+Others:     
+**********************************************************/
+uint8_t BM32S3021_1_Provision::addUnit(BM32S3021_1 *unit)
+{
+    if(_units >= BM32S3021_1_PROVISION_UNITS)
+    {
+      return 0xFF;
+    }
+    _unit[_units] = unit;
+    return _units++;
+}
+
+/**********************************************************
+Description: Set the profile written to every unit
+Parameters:  para[]: IR gesture parameters, same order as 
+                     BM32S3021_1::getIRParameters()
+             fwVer: expected version, 0: any version
+Return:          
+Others:     
+**********************************************************/
+void BM32S3021_1_Provision::setProfile(uint8_t  para[], uint16_t fwVer)
+{
+    memcpy(_para, para, 6);
+    _fwVer = fwVer;
+}
+
+/**********************************************************
+Description: Start provisioning all units
+Parameters:  
+Return:          
+Others:      Place the calibration target in front of every unit first
+**********************************************************/
+void BM32S3021_1_Provision::start()
+{
+    uint8_t i = 0;
+    for(i = 0; i < _units; i++)
+    {
+      _step[i] = BM32S3021_1_STEP_RESET;
+      _result[i] = BM32S3021_1_PROVISION_BUSY;
+    }
+    _startTime = millis();
+    _endTime = _startTime;
+    _running = 1;
+}
+
+/**********************************************************
+Description: Advance every unit by one step
+Parameters:  
+Return:      1: all units are finished 
+             0: provisioning is still running
+Others:      Call from loop() until it returns 1
+**********************************************************/
+uint8_t BM32S3021_1_Provision::run()
+{
+    uint8_t i = 0;
+    uint8_t busy = 0;
+    if(!_running)
+    {
+      return 1;
+    }
+    for(i = 0; i < _units; i++)
+    {
+      if(_result[i] == BM32S3021_1_PROVISION_BUSY)
+      {
+        step(i);
+        busy |= (_result[i] == BM32S3021_1_PROVISION_BUSY);
+      }
+    }
+    if(!busy)
+    {
+      _endTime = millis();
+      _running = 0;
+      return 1;
+    }
+    return 0;
+}
+
+/**********************************************************
+Description: Get the result of a unit
+Parameters:  index: value returned by addUnit()
+Return:      BM32S3021_1_PROVISION_PASS/FAIL/BUSY/IDLE
+Others:     
+**********************************************************/
+uint8_t BM32S3021_1_Provision::getResult(uint8_t index)
+{
+    return _result[index];
+}
+
+/**********************************************************
+Description: Get the step where a unit failed
+Parameters:  index: value returned by addUnit()
+Return:      BM32S3021_1_STEP_xxx
+Others:     
+**********************************************************/
+uint8_t BM32S3021_1_Provision::getFailStep(uint8_t index)
+{
+    return _step[index];
+}
+
+/**********************************************************
+Description: Get the fixture time of the last run
+Parameters:  
+Return:      time from start() to the last unit finished, unit: ms
+Others:     
+**********************************************************/
+uint32_t BM32S3021_1_Provision::getElapsed()
+{
+    return (_running ? millis() : _endTime) - _startTime;
+}
+
+/**********************************************************
+Description: Get the fixture throughput of the last run
+Parameters:  
+Return:      passed units per hour
+Others:     
+**********************************************************/
+uint32_t BM32S3021_1_Provision::getUnitsPerHour()
+{
+    uint8_t i = 0, passed = 0;
+    uint32_t elapsed = getElapsed();
+    for(i = 0; i < _units; i++)
+    {
+      passed += (_result[i] == BM32S3021_1_PROVISION_PASS);
+    }
+    if(elapsed == 0)
+    {
+      return 0;
+    }
+    return passed * 3600000UL / elapsed;
+}
+
+/**********************************************************
+Description: Run the current step of one unit
+Parameters:  index: unit
+Return:          
+Others:      A failed step stops the unit, _step keeps the failed step
+**********************************************************/
+void BM32S3021_1_Provision::step(uint8_t index)
+{
+    BM32S3021_1 *unit = _unit[index];
+    uint8_t check[6] = {0};
+    uint8_t ok = 1;
+    switch(_step[index])
+    {
+      case BM32S3021_1_STEP_RESET:
+        ok = (unit->reset() == SUCCESS);
+        break;
+      case BM32S3021_1_STEP_PROBE:
+        unit->probeCapability();      //Several transactions, unsupported fast paths fall back, never fails
+        break;
+      case BM32S3021_1_STEP_CONFIGURE:
+        ok = (unit->setIRParameters(_para) == SUCCESS);
+        break;
+      case BM32S3021_1_STEP_READBACK:
+        ok = (unit->getIRParameters(check) == SUCCESS) && (memcmp(check, _para, 6) == 0);
+        break;
+      case BM32S3021_1_STEP_VERSION:
+        ok = (_fwVer == 0) || (unit->getFWVer() == _fwVer);
+        break;
+      case BM32S3021_1_STEP_LEARN:
+        ok = (unit->startDistanceLearning() == SUCCESS);
+        _learnTime[index] = millis();
+        break;
+      case BM32S3021_1_STEP_WAIT:
+        if((millis() - _learnTime[index]) < BM32S3021_1_LEARN_TIME)
+        {
+          return;
+        }
+        break;
+      case BM32S3021_1_STEP_CHECK:
+        ok = (unit->readIRStatus(check) == SUCCESS) && !(check[0] & 0x08);    //Calibration is completed when BIT3 = 0
+        break;
+      default:
+        break;
+    }
+    if(!ok)
+    {
+      _result[index] = BM32S3021_1_PROVISION_FAIL;
+      return;
+    }
+    if(++_step[index] == BM32S3021_1_STEP_DONE)
+    {
+      _result[index] = BM32S3021_1_PROVISION_PASS;
+    }
+}
+
+#endif
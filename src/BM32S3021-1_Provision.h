@@ -0,0 +1,64 @@
+/*****************************************************************
+File:             BM32S3021-1_Provision.h
+Author:           BEST MODULES CORP.
+Description:      End-of-line provisioning of several BM32S3021_1 on
+                  separate UARTs: configure, calibrate and verify with
+                  the 2s distance learning of all units overlapped
+Version:          V1.0.4   -- 2025-03-13
+******************************************************************/
+#ifndef _BM32S3021_1_PROVISION_H_
+#define _BM32S3021_1_PROVISION_H_
+
+#include "BM32S3021-1.h"
+
+#if BM32S3021_1_TUNING && BM32S3021_1_DIAGNOSTICS
+
+#define BM32S3021_1_PROVISION_UNITS   4     //Units per fixture
+
+/* Unit result */
+#define BM32S3021_1_PROVISION_PASS    0
+#define BM32S3021_1_PROVISION_FAIL    1
+#define BM32S3021_1_PROVISION_BUSY    2
+#define BM32S3021_1_PROVISION_IDLE    3
+
+/* Unit steps, also the failed step reported by getFailStep() */
+#define BM32S3021_1_STEP_RESET        0
+#define BM32S3021_1_STEP_PROBE        1
+#define BM32S3021_1_STEP_CONFIGURE    2
+#define BM32S3021_1_STEP_READBACK     3
+#define BM32S3021_1_STEP_VERSION      4
+#define BM32S3021_1_STEP_LEARN        5
+#define BM32S3021_1_STEP_WAIT         6
+#define BM32S3021_1_STEP_CHECK        7
+#define BM32S3021_1_STEP_DONE         8
+
+class BM32S3021_1_Provision
+{
+  public:
+    BM32S3021_1_Provision();
+    uint8_t addUnit(BM32S3021_1 *unit);
+    void setProfile(uint8_t  para[], uint16_t fwVer = 0);
+    void start();
+    uint8_t run();
+    uint8_t getResult(uint8_t index);
+    uint8_t getFailStep(uint8_t index);
+    uint32_t getElapsed();
+    uint32_t getUnitsPerHour();
+
+  private:
+    void step(uint8_t index);
+    BM32S3021_1 *_unit[BM32S3021_1_PROVISION_UNITS];
+    uint8_t _step[BM32S3021_1_PROVISION_UNITS];
+    uint8_t _result[BM32S3021_1_PROVISION_UNITS];
+    uint32_t _learnTime[BM32S3021_1_PROVISION_UNITS];
+    uint8_t _units = 0;
+    uint8_t _para[6] = {7, 16, 50, 30, 0, 80};
+    uint16_t _fwVer = 0;
+    uint32_t _startTime = 0;
+    uint32_t _endTime = 0;
+    uint8_t _running = 0;
+};
+
+#endif
+
+#endif
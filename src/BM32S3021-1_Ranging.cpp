@@ -0,0 +1,321 @@
+/*****************************************************************
+File:             BM32S3021-1_Ranging.cpp
+Author:           BEST MODULES CORP.
+Description:      Continuous proximity ranging from the IR1/IR2 reference
+                  of a BM32S3021_1
+Version:          V1.0.4   -- 2025-03-13
+Others:           The amplitude is IR1 Ref + IR2 Ref, filtered with a
+                  Q8 fixed-point first order low pass. It is mapped to a
+                  distance by the user calibration curve (linear between
+                  points), or by the distanceLearning() reference point
+                  with an inverse-square model if there is no curve.
+******************************************************************/
+#include "BM32S3021-1_Ranging.h"
+
+#if BM32S3021_1_DIAGNOSTICS
+
+/**********************************************************
+Description: Constructor
+Parameters:  gesture: module to be read, begin() must have been called
+Return:          
+Others:     
+**********************************************************/
+BM32S3021_1_Ranging::BM32S3021_1_Ranging(BM32S3021_1 *gesture)
+{
+    _gesture = gesture;
+}
+
+/**********************************************************
+Description: Start ranging
+Parameters:  periodMs: update period, unit: ms
+                       parameter range: one IR reference transaction 
+                       or more: BM32S3021_1_RANGING_WIRE + getTurnaround() 
+                       ~65535, i.e. 25 unprobed, about 16 probed (Default 25)
+             filterShift: low pass strength, each update moves the 
+                          filtered amplitude by 1/2^filterShift
+                          parameter range: 0~8 (Default 2)
+Return:      0:Success 1:Fail(periodMs is too short, the minimum is used)  
+Others:      Call after probeCapability() or setTurnaround(), the 
+             minimum period uses the gap in force at begin()
+**********************************************************/
+uint8_t BM32S3021_1_Ranging::begin(uint16_t periodMs, uint8_t filterShift)
+{
+    uint16_t minPeriod = BM32S3021_1_RANGING_WIRE + (_gesture->getTurnaround() + 999) / 1000;
+    uint8_t status = SUCCESS;
+    if(periodMs < minPeriod)
+    {
+      periodMs = minPeriod;
+      status = FAIL;
+    }
+    _period = periodMs;
+    _shift = filterShift;
+    _primed = 0;
+    _missed = 0;
+    _nextTime = millis();
+    return status;
+}
+
+/**********************************************************
+Description: Learn the reference point
+Parameters:  distance: distance of the object placed in front of 
+                       the module, any unit (mm recommended)
+Return:      Communication status  0:Success 1:Fail   
+Others:      Runs distanceLearning() of the module (2s) and records 
+             the averaged amplitude at that distance
+**********************************************************/
+uint8_t BM32S3021_1_Ranging::learnReference(uint16_t distance)
+{
+    uint16_t amplitude = 0;
+    if((_gesture->distanceLearning() != SUCCESS) || (averageAmplitude(&amplitude) != SUCCESS) || (amplitude == 0))
+    {
+      return FAIL;
+    }
+    _refAmplitude = amplitude;
+    _refDistance = distance;
+    return SUCCESS;
+}
+
+/**********************************************************
+Description: Add a point to the calibration curve
+Parameters:  distance: distance of the object placed in front of 
+                       the module, same unit as learnReference()
+Return:      0:Success 1:Fail(communication or curve full)  
+Others:      The curve is kept sorted by amplitude, a point with 
+             the same amplitude replaces the old one
+**********************************************************/
+uint8_t BM32S3021_1_Ranging::addCalibrationPoint(uint16_t distance)
+{
+    uint16_t amplitude = 0;
+    uint8_t i = 0, j = 0;
+    if(averageAmplitude(&amplitude) != SUCCESS)
+    {
+      return FAIL;
+    }
+    for(i = 0; i < _points; i++)
+    {
+      if(_curveAmplitude[i] == amplitude)
+      {
+        _curveDistance[i] = distance;
+        return SUCCESS;
+      }
+      if(_curveAmplitude[i] < amplitude)
+      {
+        break;
+      }
+    }
+    if(_points >= BM32S3021_1_RANGING_POINTS)
+    {
+      return FAIL;
+    }
+    for(j = _points; j > i; j--)
+    {
+      _curveAmplitude[j] = _curveAmplitude[j-1];
+      _curveDistance[j] = _curveDistance[j-1];
+    }
+    _curveAmplitude[i] = amplitude;
+    _curveDistance[i] = distance;
+    _points++;
+    return SUCCESS;
+}
+
+/**********************************************************
+Description: Remove all calibration curve points
+Parameters:  
+Return:          
+Others:      The reference point is kept
+**********************************************************/
+void BM32S3021_1_Ranging::clearCalibration()
+{
+    _points = 0;
+}
+
+/**********************************************************
+Description: Run the ranging schedule
+Parameters:  
+Return:      1: a new distance was published 
+             0: the period has not elapsed yet
+Others:      Call from loop() at least once per period. Updates are 
+             scheduled on a fixed grid, so the rate does not drift 
+             with loop() timing. A failed read republishes the last 
+             value to keep the rate. If a whole period is lost, the 
+             grid restarts and getMissedUpdates() is incremented.
+**********************************************************/
+uint8_t BM32S3021_1_Ranging::update()
+{
+    uint16_t amplitude = 0;
+    uint32_t now = millis();
+    if((int32_t)(now - _nextTime) < 0)
+    {
+      return 0;
+    }
+    _nextTime += _period;
+    if((int32_t)(now - _nextTime) >= 0)
+    {
+      _missed++;
+      _nextTime = now + _period;
+    }
+    if(readAmplitude(&amplitude) == SUCCESS)
+    {
+      if(!_primed)
+      {
+        _filtered = (uint32_t)amplitude << 8;
+        _primed = 1;
+      }
+      else
+      {
+        _filtered = _filtered - (_filtered >> _shift) + (((uint32_t)amplitude << 8) >> _shift);
+      }
+    }
+    if(_primed)
+    {
+      _distance = toDistance(getAmplitude());
+    }
+    return 1;
+}
+
+/**********************************************************
+Description: Get the estimated distance
+Parameters:  
+Return:      distance in the calibration unit, 
+             BM32S3021_1_RANGING_NONE if not calibrated
+Others:      
+**********************************************************/
+uint16_t BM32S3021_1_Ranging::getDistance()
+{
+    return _distance;
+}
+
+/**********************************************************
+Description: Get the filtered amplitude
+Parameters:  
+Return:      IR1 Ref + IR2 Ref after the low pass: 0~510
+Others:      
+**********************************************************/
+uint16_t BM32S3021_1_Ranging::getAmplitude()
+{
+    return (_filtered + 0x80) >> 8;
+}
+
+/**********************************************************
+Description: Get the number of periods lost since begin()
+Parameters:  
+Return:      lost periods
+Others:      Non-zero means loop() or the period is too slow for 
+             the guaranteed rate
+**********************************************************/
+uint16_t BM32S3021_1_Ranging::getMissedUpdates()
+{
+    return _missed;
+}
+
+/**********************************************************
+Description: Read the amplitude once
+Parameters:  amplitude: Stores IR1 Ref + IR2 Ref
+Return:      Communication status  0:Success 1:Fail   
+Others:      One block read of the module
+**********************************************************/
+uint8_t BM32S3021_1_Ranging::readAmplitude(uint16_t *amplitude)
+{
+    uint8_t ref[2] = {0};
+    if(_gesture->readIRRef(ref) != SUCCESS)
+    {
+      return FAIL;
+    }
+    *amplitude = ref[0] + ref[1];
+    return SUCCESS;
+}
+
+/**********************************************************
+Description: Read the averaged amplitude for calibration
+Parameters:  amplitude: Stores the average of BM32S3021_1_RANGING_SAMPLES reads
+Return:      Communication status  0:Success 1:Fail   
+Others:      
+**********************************************************/
+uint8_t BM32S3021_1_Ranging::averageAmplitude(uint16_t *amplitude)
+{
+    uint16_t value = 0;
+    uint16_t sum = 0;
+    uint8_t i = 0;
+    for(i = 0; i < BM32S3021_1_RANGING_SAMPLES; i++)
+    {
+      if(readAmplitude(&value) != SUCCESS)
+      {
+        return FAIL;
+      }
+      sum += value;
+    }
+    *amplitude = (sum + BM32S3021_1_RANGING_SAMPLES / 2) / BM32S3021_1_RANGING_SAMPLES;
+    return SUCCESS;
+}
+
+/**********************************************************
+Description: Map an amplitude to a distance
+Parameters:  amplitude: filtered amplitude
+Return:      distance, BM32S3021_1_RANGING_NONE if not calibrated
+Others:      Curve(2 points or more): linear between the points, clamped to the 
+             closest/farthest point. Reference only: 
+             distance = refDistance × sqrt(refAmplitude / amplitude)
+**********************************************************/
+uint16_t BM32S3021_1_Ranging::toDistance(uint16_t amplitude)
+{
+    uint8_t i = 0;
+    uint32_t distance = 0;
+    if(_points >= 2)
+    {
+      if(amplitude >= _curveAmplitude[0])
+      {
+        return _curveDistance[0];
+      }
+      for(i = 1; i < _points; i++)
+      {
+        if(amplitude >= _curveAmplitude[i])
+        {
+          return _curveDistance[i] + ((int32_t)_curveDistance[i-1] - (int32_t)_curveDistance[i])
+                 * (int32_t)(amplitude - _curveAmplitude[i]) / (int32_t)(_curveAmplitude[i-1] - _curveAmplitude[i]);
+        }
+      }
+      return _curveDistance[_points - 1];
+    }
+    if(_refAmplitude == 0)
+    {
+      return BM32S3021_1_RANGING_NONE;
+    }
+    if(amplitude == 0)
+    {
+      amplitude = 1;
+    }
+    distance = ((uint32_t)_refDistance * sqrt32(((uint32_t)_refAmplitude << 16) / amplitude)) >> 8;
+    return (distance >= BM32S3021_1_RANGING_NONE) ? (BM32S3021_1_RANGING_NONE - 1) : distance;
+}
+
+/**********************************************************
+Description: Integer square root
+Parameters:  value: 0~0xFFFFFFFF
+Return:      floor(sqrt(value))
+Others:      
+**********************************************************/
+uint16_t BM32S3021_1_Ranging::sqrt32(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while(bit > value)
+    {
+      bit >>= 2;
+    }
+    while(bit != 0)
+    {
+      if(value >= root + bit)
+      {
+        value -= root + bit;
+        root = (root >> 1) + bit;
+      }
+      else
+      {
+        root >>= 1;
+      }
+      bit >>= 2;
+    }
+    return root;
+}
+
+#endif
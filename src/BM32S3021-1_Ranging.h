@@ -0,0 +1,55 @@
+/*****************************************************************
+File:             BM32S3021-1_Ranging.h
+Author:           BEST MODULES CORP.
+Description:      Continuous proximity ranging from the IR1/IR2 reference
+                  of a BM32S3021_1
+Version:          V1.0.4   -- 2025-03-13
+******************************************************************/
+#ifndef _BM32S3021_1_RANGING_H_
+#define _BM32S3021_1_RANGING_H_
+
+#include "BM32S3021-1.h"
+
+#if BM32S3021_1_DIAGNOSTICS
+
+#define BM32S3021_1_RANGING_POINTS    8     //Calibration curve points
+#define BM32S3021_1_RANGING_SAMPLES   8     //Reads averaged per calibration point
+#define BM32S3021_1_RANGING_NONE      0xFFFF  //No reference and no curve yet
+#define BM32S3021_1_RANGING_WIRE      15    //IR reference transaction on the wire: 14 bytes at 9600bps, unit: ms
+
+class BM32S3021_1_Ranging
+{
+  public:
+    BM32S3021_1_Ranging(BM32S3021_1 *gesture);
+    uint8_t begin(uint16_t periodMs = 25, uint8_t filterShift = 2);
+    uint8_t learnReference(uint16_t distance);
+    uint8_t addCalibrationPoint(uint16_t distance);
+    void clearCalibration();
+    uint8_t update();
+    uint16_t getDistance();
+    uint16_t getAmplitude();
+    uint16_t getMissedUpdates();
+
+  private:
+    uint8_t readAmplitude(uint16_t *amplitude);
+    uint8_t averageAmplitude(uint16_t *amplitude);
+    uint16_t toDistance(uint16_t amplitude);
+    static uint16_t sqrt32(uint32_t value);
+    BM32S3021_1 *_gesture;
+    uint16_t _period = 25;
+    uint8_t _shift = 2;
+    uint32_t _nextTime = 0;
+    uint32_t _filtered = 0;         //Amplitude, Q8 fixed point
+    uint8_t _primed = 0;
+    uint16_t _distance = BM32S3021_1_RANGING_NONE;
+    uint16_t _missed = 0;
+    uint16_t _refAmplitude = 0;
+    uint16_t _refDistance = 0;
+    uint8_t _points = 0;
+    uint16_t _curveAmplitude[BM32S3021_1_RANGING_POINTS];   //Descending, closest first
+    uint16_t _curveDistance[BM32S3021_1_RANGING_POINTS];
+};
+
+#endif
+
+#endif
@@ -0,0 +1,262 @@
+/*****************************************************************
+File:             BM32S3021-1_Task.cpp
+Author:           BEST MODULES CORP.
+Description:      Concurrency-safe access to one BM32S3021_1 from several
+                  FreeRTOS tasks (ESP32) or host threads: a driver task owns
+                  the UART and serves requests from a bounded queue
+Version:          V1.0.4   -- 2025-03-13
+******************************************************************/
+#include "BM32S3021-1_Task.h"
+
+#if BM32S3021_1_OS
+
+#define CMD_IR_STATUS           0
+#define CMD_DISTANCE_LEARNING   1
+#define CMD_RESET               2
+#define CMD_GESTURE_NUM         3
+#define CMD_FW_VER              4
+#define CMD_GET_PARAMETERS      5
+#define CMD_SET_PARAMETERS      6
+#define CMD_SET_DEBOUNCE        7
+#define CMD_SET_THRESHOLD       8
+#define CMD_SET_IRQ_TIME        9
+#define CMD_SET_CONTINUITY      10
+#define CMD_SET_FASTEST         11
+#define CMD_SET_SLOWEST         12
+
+#define SUBMIT_TIMEOUT          100   //Wait for a free request slot, unit: ms
+
+/**********************************************************
+Description: Constructor
+Parameters:  gesture: driver owned by the task, it must not be 
+                      called directly once begin() has been called
+Return:          
+Others:     
+**********************************************************/
+BM32S3021_1_Task::BM32S3021_1_Task(BM32S3021_1 *gesture)
+{
+    _gesture = gesture;
+}
+
+/**********************************************************
+Description: Initial the module and start the driver task
+Parameters:  baud: see BM32S3021_1::begin()
+             probe: see BM32S3021_1::begin()
+             priority: FreeRTOS priority of the driver task, 
+                       ignored on a host build
+Return:      0:Success 1:Fail   
+Others:      
+**********************************************************/
+uint8_t BM32S3021_1_Task::begin(uint16_t baud, uint8_t probe, BM32S3021_1_Priority priority)
+{
+    _gesture->begin(baud, probe);
+    if((_requestQueue.create(BM32S3021_1_TASK_QUEUE_LEN, sizeof(Request *)) != SUCCESS)
+       || (_eventQueue.create(BM32S3021_1_TASK_EVENT_LEN, sizeof(BM32S3021_1_Event)) != SUCCESS))
+    {
+      return FAIL;
+    }
+    return BM32S3021_1_startThread(taskEntry, this, BM32S3021_1_TASK_STACK, priority);
+}
+
+/**********************************************************
+Description: Get the next swipe gesture
+Parameters:  event: Stores the gesture
+             timeOut: wait time if no gesture is pending, unit: ms
+Return:      0:Success 1:no gesture   
+Others:      The driver task reads the status while INT is low and 
+             queues one event per INT low period that has a swipe
+**********************************************************/
+uint8_t BM32S3021_1_Task::getGestureEvent(BM32S3021_1_Event *event, uint32_t timeOut)
+{
+    return _eventQueue.receive(event, timeOut);
+}
+
+/**********************************************************
+Description: Thread-safe BM32S3021_1 calls
+Parameters:  see BM32S3021_1
+Return:      see BM32S3021_1, the failure value of the call if the 
+             request queue stays full for SUBMIT_TIMEOUT
+Others:      
+**********************************************************/
+uint8_t BM32S3021_1_Task::getIRStatus()
+{
+    return request(CMD_IR_STATUS, 0);
+}
+
+uint8_t BM32S3021_1_Task::distanceLearning()
+{
+    return request(CMD_DISTANCE_LEARNING, FAIL);
+}
+
+uint8_t BM32S3021_1_Task::reset()
+{
+    return request(CMD_RESET, FAIL);
+}
+
+#if BM32S3021_1_DIAGNOSTICS
+uint8_t BM32S3021_1_Task::getIRGestureNum()
+{
+    return request(CMD_GESTURE_NUM, 0);
+}
+
+uint16_t BM32S3021_1_Task::getFWVer()
+{
+    return request(CMD_FW_VER, 0);
+}
+#endif
+
+#if BM32S3021_1_TUNING
+uint8_t BM32S3021_1_Task::getIRParameters(uint8_t  buff[])
+{
+    return request(CMD_GET_PARAMETERS, FAIL, 0, buff);
+}
+
+uint8_t BM32S3021_1_Task::setIRParameters(uint8_t  buff[])
+{
+    return request(CMD_SET_PARAMETERS, FAIL, 0, buff);
+}
+
+uint8_t BM32S3021_1_Task::setIRDebounce(uint8_t  debounce)
+{
+    return request(CMD_SET_DEBOUNCE, FAIL, debounce);
+}
+
+uint8_t BM32S3021_1_Task::setIRThreshold(uint8_t  threshold)
+{
+    return request(CMD_SET_THRESHOLD, FAIL, threshold);
+}
+
+uint8_t BM32S3021_1_Task::setIRQTrigerTime(uint8_t  irqTime)
+{
+    return request(CMD_SET_IRQ_TIME, FAIL, irqTime);
+}
+
+uint8_t BM32S3021_1_Task::setIRContinutyGestureTime(uint8_t  irTime)
+{
+    return request(CMD_SET_CONTINUITY, FAIL, irTime);
+}
+
+uint8_t BM32S3021_1_Task::setIRFastestGestureTime(uint8_t  irTime)
+{
+    return request(CMD_SET_FASTEST, FAIL, irTime);
+}
+
+uint8_t BM32S3021_1_Task::setIRSlowestGestureTime(uint8_t  irTime)
+{
+    return request(CMD_SET_SLOWEST, FAIL, irTime);
+}
+#endif
+
+/**********************************************************
+Description: Submit a request and wait for its result
+Parameters:  cmd: CMD_xxx
+             fail: result if the request cannot be queued
+             arg: parameter of set calls
+             buff: buffer of block calls
+Return:      result of the call
+Others:      No lock is held while the driver task talks to the 
+             module: the caller only blocks on its own signal, 
+             which lives on its stack, so no allocation is needed
+**********************************************************/
+uint16_t BM32S3021_1_Task::request(uint8_t cmd, uint16_t fail, uint8_t arg, uint8_t *buff)
+{
+    BM32S3021_1_Signal done;
+    Request req;
+    Request *pReq = &req;
+    req.cmd = cmd;
+    req.arg = arg;
+    req.buff = buff;
+    req.result = fail;
+    req.done = &done;
+    if(_requestQueue.send(&pReq, SUBMIT_TIMEOUT) == SUCCESS)
+    {
+      done.take();
+    }
+    return req.result;
+}
+
+/**********************************************************
+Description: Run one request on the driver task
+Parameters:  req: request, not touched after it is completed
+Return:      
+Others:      
+**********************************************************/
+void BM32S3021_1_Task::serve(Request *req)
+{
+    uint16_t result = req->result;
+    switch(req->cmd)
+    {
+      case CMD_IR_STATUS:         result = _gesture->getIRStatus(); break;
+      case CMD_DISTANCE_LEARNING: result = _gesture->distanceLearning(); break;
+      case CMD_RESET:             result = _gesture->reset(); break;
+#if BM32S3021_1_DIAGNOSTICS
+      case CMD_GESTURE_NUM:       result = _gesture->getIRGestureNum(); break;
+      case CMD_FW_VER:            result = _gesture->getFWVer(); break;
+#endif
+#if BM32S3021_1_TUNING
+      case CMD_GET_PARAMETERS:    result = _gesture->getIRParameters(req->buff); break;
+      case CMD_SET_PARAMETERS:    result = _gesture->setIRParameters(req->buff); break;
+      case CMD_SET_DEBOUNCE:      result = _gesture->setIRDebounce(req->arg); break;
+      case CMD_SET_THRESHOLD:     result = _gesture->setIRThreshold(req->arg); break;
+      case CMD_SET_IRQ_TIME:      result = _gesture->setIRQTrigerTime(req->arg); break;
+      case CMD_SET_CONTINUITY:    result = _gesture->setIRContinutyGestureTime(req->arg); break;
+      case CMD_SET_FASTEST:       result = _gesture->setIRFastestGestureTime(req->arg); break;
+      case CMD_SET_SLOWEST:       result = _gesture->setIRSlowestGestureTime(req->arg); break;
+#endif
+      default: break;
+    }
+    req->result = result;
+    req->done->give();
+}
+
+/**********************************************************
+Description: Queue a gesture event for the current INT low period
+Parameters:  
+Return:      
+Others:      The status is read every poll while INT is low until 
+             a swipe is decoded. Events are dropped if the event 
+             queue is full.
+**********************************************************/
+void BM32S3021_1_Task::pollGesture()
+{
+    BM32S3021_1_Event event;
+    if(_gesture->getINT())
+    {
+      _reported = 0;
+      return;
+    }
+    if(_reported)
+    {
+      return;
+    }
+    event.irStatus = _gesture->getIRStatus();
+    if(!(event.irStatus & 0x08) && (event.irStatus & 0x06))
+    {
+      event.readTime = micros();
+      event.fallTime = _gesture->getINTFallTime();
+      _eventQueue.send(&event, 0);
+      _reported = 1;
+    }
+}
+
+/**********************************************************
+Description: Driver task
+Parameters:  param: BM32S3021_1_Task object
+Return:      
+Others:      The only place that talks to the module
+**********************************************************/
+void BM32S3021_1_Task::taskEntry(void *param)
+{
+    BM32S3021_1_Task *self = (BM32S3021_1_Task *)param;
+    Request *req = NULL;
+    for(;;)
+    {
+      if(self->_requestQueue.receive(&req, BM32S3021_1_TASK_POLL) == SUCCESS)
+      {
+        self->serve(req);
+      }
+      self->pollGesture();
+    }
+}
+
+#endif
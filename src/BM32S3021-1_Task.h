@@ -0,0 +1,75 @@
+/*****************************************************************
+File:             BM32S3021-1_Task.h
+Author:           BEST MODULES CORP.
+Description:      Concurrency-safe access to one BM32S3021_1 from several
+                  FreeRTOS tasks (ESP32) or host threads: a driver task owns
+                  the UART and serves requests from a bounded queue
+Version:          V1.0.4   -- 2025-03-13
+******************************************************************/
+#ifndef _BM32S3021_1_TASK_H_
+#define _BM32S3021_1_TASK_H_
+
+#include "BM32S3021-1.h"
+#include "BM32S3021-1_OS.h"
+
+#if BM32S3021_1_OS
+
+#define BM32S3021_1_TASK_QUEUE_LEN    8     //Pending requests
+#define BM32S3021_1_TASK_EVENT_LEN    8     //Gesture events not read yet
+#define BM32S3021_1_TASK_STACK        3072  //FreeRTOS only
+#define BM32S3021_1_TASK_POLL         10    //INT poll period when idle, unit: ms
+
+typedef struct
+{
+    uint8_t irStatus;       //Same bits as BM32S3021_1::getIRStatus()
+    uint32_t fallTime;      //INT falling edge, micros(), 0 without enableINTTimestamp()
+    uint32_t readTime;      //micros() when the status was decoded
+} BM32S3021_1_Event;
+
+class BM32S3021_1_Task
+{
+  public:
+    BM32S3021_1_Task(BM32S3021_1 *gesture);
+    uint8_t begin(uint16_t baud = 9600, uint8_t probe = 0, BM32S3021_1_Priority priority = 2);
+    uint8_t getGestureEvent(BM32S3021_1_Event *event, uint32_t timeOut = 0);
+
+    uint8_t getIRStatus();
+    uint8_t distanceLearning();
+    uint8_t reset();
+#if BM32S3021_1_DIAGNOSTICS
+    uint8_t getIRGestureNum();
+    uint16_t getFWVer();
+#endif
+#if BM32S3021_1_TUNING
+    uint8_t getIRParameters(uint8_t  buff[]);
+    uint8_t setIRParameters(uint8_t  buff[]);
+    uint8_t setIRDebounce(uint8_t  debounce = 7);
+    uint8_t setIRThreshold(uint8_t  threshold = 16);
+    uint8_t setIRQTrigerTime(uint8_t  irqTime = 50);
+    uint8_t setIRContinutyGestureTime(uint8_t  irTime = 30);
+    uint8_t setIRFastestGestureTime(uint8_t  irTime = 0);
+    uint8_t setIRSlowestGestureTime(uint8_t  irTime = 80);
+#endif
+
+  private:
+    typedef struct
+    {
+      uint8_t cmd;
+      uint8_t arg;
+      uint8_t *buff;
+      uint16_t result;
+      BM32S3021_1_Signal *done;
+    } Request;
+    uint16_t request(uint8_t cmd, uint16_t fail, uint8_t arg = 0, uint8_t *buff = NULL);
+    void serve(Request *req);
+    void pollGesture();
+    static void taskEntry(void *param);
+    BM32S3021_1 *_gesture;
+    BM32S3021_1_Queue _requestQueue;
+    BM32S3021_1_Queue _eventQueue;
+    uint8_t _reported = 0;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,314 @@
+/*****************************************************************
+File:             BM32S3021-1_TimerSerial.cpp
+Author:           BEST MODULES CORP.
+Description:      Timer interrupt driven half-duplex software UART used by
+                  the intPin/rxPin/txPin constructor when
+                  BM32S3021_1_TIMERSERIAL is 1
+Version:          V1.0.4   -- 2025-03-13
+Others:           Timer2 compare B interrupts at 3 times the baud rate
+                  shift TX bits out and sample RX, so interrupts are never
+                  disabled for a whole byte like SoftwareSerial does.
+                  The timer only runs while a frame is being sent and
+                  during the reply listen window, and it is shared with
+                  tone() and PWM on the Timer2 pins.
+******************************************************************/
+#include "BM32S3021-1.h"
+
+#if BM32S3021_1_SOFTSERIAL && BM32S3021_1_TIMERSERIAL
+#if !defined(__AVR__) || !defined(TCCR2A)
+#error "BM32S3021_1_TIMERSERIAL needs an AVR board with Timer2"
+#endif
+
+BM32S3021_1_TimerSerial *BM32S3021_1_TimerSerial::_active = NULL;
+
+/**********************************************************
+Description: Constructor
+Parameters:  rxPin: Receiver pin of the UART
+             txPin: Send signal pin of UART
+Return:
+Others:
+**********************************************************/
+BM32S3021_1_TimerSerial::BM32S3021_1_TimerSerial(uint8_t rxPin, uint8_t txPin)
+{
+    _rxPin = rxPin;
+    _txPin = txPin;
+    _running = 0;
+    _txHead = 0;
+    _txTail = 0;
+    _txBitCnt = 0;
+    _rxHead = 0;
+    _rxTail = 0;
+    _rxBitCnt = 0;
+}
+
+/**********************************************************
+Description: Initial the pins and the Timer2 rate
+Parameters:  baud: communication baud rate
+Return:
+Others:      Only one BM32S3021_1_TimerSerial can be active, the
+             last one to call begin() owns Timer2
+**********************************************************/
+void BM32S3021_1_TimerSerial::begin(long baud)
+{
+    uint32_t top = (F_CPU / 8 + baud * 3 / 2) / (baud * 3);
+    _timerClock = _BV(CS21);                        //clk/8
+    if(top > 256)
+    {
+      top = (F_CPU / 32 + baud * 3 / 2) / (baud * 3);
+      _timerClock = _BV(CS21) | _BV(CS20);          //clk/32
+    }
+    _timerTop = top - 1;
+    _listenTicks = (uint32_t)baud * 3 * BM32S3021_1_TIMERSERIAL_LISTEN / 1000;
+
+    _txReg = portOutputRegister(digitalPinToPort(_txPin));
+    _txMask = digitalPinToBitMask(_txPin);
+    _rxReg = portInputRegister(digitalPinToPort(_rxPin));
+    _rxMask = digitalPinToBitMask(_rxPin);
+    digitalWrite(_txPin, HIGH);
+    pinMode(_txPin, OUTPUT);
+    pinMode(_rxPin, INPUT_PULLUP);
+    _active = this;
+}
+
+/**********************************************************
+Description: Number of received bytes
+Parameters:
+Return:      received bytes not read yet
+Others:
+**********************************************************/
+int BM32S3021_1_TimerSerial::available()
+{
+    return (uint8_t)(_rxHead + BM32S3021_1_TIMERSERIAL_RX_SIZE - _rxTail) % BM32S3021_1_TIMERSERIAL_RX_SIZE;
+}
+
+/**********************************************************
+Description: Read a received byte
+Parameters:
+Return:      0~255, -1 if nothing is received
+Others:
+**********************************************************/
+int BM32S3021_1_TimerSerial::read()
+{
+    uint8_t data = 0;
+    if(_rxHead == _rxTail)
+    {
+      return -1;
+    }
+    data = _rxBuf[_rxTail];
+    _rxTail = (_rxTail + 1) % BM32S3021_1_TIMERSERIAL_RX_SIZE;
+    return data;
+}
+
+/**********************************************************
+Description: Look at a received byte without reading it
+Parameters:
+Return:      0~255, -1 if nothing is received
+Others:
+**********************************************************/
+int BM32S3021_1_TimerSerial::peek()
+{
+    if(_rxHead == _rxTail)
+    {
+      return -1;
+    }
+    return _rxBuf[_rxTail];
+}
+
+/**********************************************************
+Description: Wait until every queued byte is sent
+Parameters:
+Return:
+Others:      Interrupts stay enabled while waiting
+**********************************************************/
+void BM32S3021_1_TimerSerial::flush()
+{
+    while((_txBitCnt != 0) || (_txHead != _txTail))
+    {
+    }
+}
+
+/**********************************************************
+Description: Queue a byte to be sent
+Parameters:  data: byte to be sent
+Return:      1
+Others:      Only waits if the TX queue is full. The start bit 
+             is sent by tick(), so every bit edge is on a tick
+**********************************************************/
+size_t BM32S3021_1_TimerSerial::write(uint8_t data)
+{
+    uint8_t next = (_txHead + 1) % BM32S3021_1_TIMERSERIAL_TX_SIZE;
+    while(next == _txTail)
+    {
+    }
+    _txBuf[_txHead] = data;
+    _txHead = next;
+    noInterrupts();
+    startTimer();
+    interrupts();
+    return 1;
+}
+
+/**********************************************************
+Description: Queue a frame to be sent
+Parameters:  buffer: bytes to be sent
+             size: number of bytes
+Return:      size
+Others:      Returns as soon as the frame is queued
+**********************************************************/
+size_t BM32S3021_1_TimerSerial::write(const uint8_t *buffer, size_t size)
+{
+    size_t i = 0;
+    for(i = 0; i < size; i++)
+    {
+      write(buffer[i]);
+    }
+    return size;
+}
+
+/**********************************************************
+Description: Timer2 interrupt entry
+Parameters:
+Return:
+Others:
+**********************************************************/
+void BM32S3021_1_TimerSerial::timerHandler()
+{
+    if(_active != NULL)
+    {
+      _active->tick();
+    }
+}
+
+/**********************************************************
+Description: Start Timer2 if it is stopped
+Parameters:
+Return:
+Others:      Call with interrupts disabled
+**********************************************************/
+void BM32S3021_1_TimerSerial::startTimer()
+{
+    _rxIdle = 0;
+    if(_running)
+    {
+      return;
+    }
+    _running = 1;
+    TCCR2A = _BV(WGM21);              //CTC, TOP = OCR2A
+    TCCR2B = _timerClock;
+    OCR2A = _timerTop;
+    OCR2B = 0;
+    TCNT2 = 0;
+    TIFR2 = _BV(OCF2B);
+    TIMSK2 |= _BV(OCIE2B);
+}
+
+/**********************************************************
+Description: Load the next queued byte and send its start bit
+Parameters:
+Return:
+Others:      Called from tick(). Any partly received byte is 
+             dropped, the line is half-duplex
+**********************************************************/
+void BM32S3021_1_TimerSerial::txNext()
+{
+    if(_txHead == _txTail)
+    {
+      return;
+    }
+    _txShift = ((uint16_t)_txBuf[_txTail] << 1) | 0x200;   //start bit, 8 data bits LSB first, stop bit
+    _txTail = (_txTail + 1) % BM32S3021_1_TIMERSERIAL_TX_SIZE;
+    _txBitCnt = 10;
+    _txTick = 0;
+    _rxBitCnt = 0;
+    *_txReg &= ~_txMask;
+}
+
+/**********************************************************
+Description: One tick at 3 times the baud rate
+Parameters:
+Return:
+Others:      A queued byte starts on the next tick when TX is 
+             idle. TX changes the pin every 3 ticks. RX hunts the start
+             bit every tick, samples the first data bit 4.5 ticks 
+             (1.5 bit times) +-0.5 tick after the falling edge and 
+             each following bit 3 ticks later, near bit centre. Timer2 is
+             stopped when nothing is received during the listen
+             window.
+**********************************************************/
+void BM32S3021_1_TimerSerial::tick()
+{
+    uint8_t bit = 0;
+    uint8_t next = 0;
+    if(_txBitCnt != 0)
+    {
+      if(++_txTick == 3)
+      {
+        _txTick = 0;
+        _txShift >>= 1;
+        if(--_txBitCnt == 0)
+        {
+          txNext();
+        }
+        else if(_txShift & 0x01)
+        {
+          *_txReg |= _txMask;
+        }
+        else
+        {
+          *_txReg &= ~_txMask;
+        }
+      }
+      return;
+    }
+    if(_txHead != _txTail)
+    {
+      txNext();
+      return;
+    }
+
+    bit = *_rxReg & _rxMask;
+    if(_rxBitCnt == 0)
+    {
+      if(!bit)
+      {
+        _rxBitCnt = 9;                //8 data bits and the stop bit
+        _rxTick = 4;
+        _rxData = 0;
+        _rxIdle = 0;
+      }
+      else if(++_rxIdle >= _listenTicks)
+      {
+        TIMSK2 &= ~_BV(OCIE2B);
+        _running = 0;
+      }
+    }
+    else if(--_rxTick == 0)
+    {
+      _rxTick = 3;
+      if(_rxBitCnt > 1)
+      {
+        _rxData >>= 1;
+        if(bit)
+        {
+          _rxData |= 0x80;
+        }
+      }
+      else if(bit)
+      {
+        next = (_rxHead + 1) % BM32S3021_1_TIMERSERIAL_RX_SIZE;
+        if(next != _rxTail)
+        {
+          _rxBuf[_rxHead] = _rxData;
+          _rxHead = next;
+        }
+      }
+      _rxBitCnt--;
+    }
+}
+
+ISR(TIMER2_COMPB_vect)
+{
+    BM32S3021_1_TimerSerial::timerHandler();
+}
+
+#endif
@@ -0,0 +1,62 @@
+/*****************************************************************
+File:             BM32S3021-1_TimerSerial.h
+Author:           BEST MODULES CORP.
+Description:      Timer interrupt driven half-duplex software UART used by
+                  the intPin/rxPin/txPin constructor when
+                  BM32S3021_1_TIMERSERIAL is 1
+Version:          V1.0.4   -- 2025-03-13
+******************************************************************/
+#ifndef _BM32S3021_1_TIMERSERIAL_H_
+#define _BM32S3021_1_TIMERSERIAL_H_
+
+#include "Arduino.h"
+
+#define BM32S3021_1_TIMERSERIAL_TX_SIZE     16    //Longest command frame is 11 bytes
+#define BM32S3021_1_TIMERSERIAL_RX_SIZE     16    //Longest reply frame is 11 bytes
+#define BM32S3021_1_TIMERSERIAL_LISTEN      30    //RX listen window after TX or last byte, unit: ms
+
+class BM32S3021_1_TimerSerial : public Stream
+{
+  public:
+    BM32S3021_1_TimerSerial(uint8_t rxPin, uint8_t txPin);
+    void begin(long baud);
+    int available();
+    int read();
+    int peek();
+    void flush();
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *buffer, size_t size);
+    using Print::write;
+    static void timerHandler();
+
+  private:
+    void startTimer();
+    void txNext();
+    void tick();
+    static BM32S3021_1_TimerSerial *_active;
+    uint8_t _rxPin;
+    uint8_t _txPin;
+    volatile uint8_t *_rxReg;
+    volatile uint8_t *_txReg;
+    uint8_t _rxMask;
+    uint8_t _txMask;
+    uint8_t _timerTop;
+    uint8_t _timerClock;
+    uint16_t _listenTicks;
+    volatile uint8_t _running;
+    volatile uint8_t _txBuf[BM32S3021_1_TIMERSERIAL_TX_SIZE];
+    volatile uint8_t _txHead;
+    volatile uint8_t _txTail;
+    volatile uint16_t _txShift;
+    volatile uint8_t _txBitCnt;
+    volatile uint8_t _txTick;
+    volatile uint8_t _rxBuf[BM32S3021_1_TIMERSERIAL_RX_SIZE];
+    volatile uint8_t _rxHead;
+    volatile uint8_t _rxTail;
+    volatile uint8_t _rxData;
+    volatile uint8_t _rxBitCnt;
+    volatile uint8_t _rxTick;
+    volatile uint16_t _rxIdle;
+};
+
+#endif